@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDebug>
+#include <QSaveFile>
+#include <QString>
+
+/**
+ * Replaces @p path with @p content at once, readers see the old or the new file, never a part.
+ */
+inline bool writeAtomically(const QString &path, const QByteArray &content)
+{
+    QSaveFile file{path};
+    if (!file.open(QIODevice::WriteOnly) || file.write(content) < 0 || !file.commit()) {
+        qWarning() << "Couldn't write" << path << ":" << file.errorString();
+        return false;
+    }
+    return true;
+}
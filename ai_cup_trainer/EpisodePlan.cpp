@@ -0,0 +1,18 @@
+#include "EpisodePlan.h"
+
+using namespace std;
+
+RepeatPlan::RepeatPlan(int episodes) : m_episodes{episodes} {}
+
+optional<EpisodeJob> RepeatPlan::next()
+{
+    if (done())
+        return nullopt;
+    ++m_started;
+    return EpisodeJob{};
+}
+
+bool RepeatPlan::done() const
+{
+    return m_episodes > 0 && m_started >= m_episodes;
+}
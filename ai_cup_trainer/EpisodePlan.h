@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QJsonValue>
+#include <QString>
+
+#include <optional>
+
+#include "ResultAggregator.h"
+
+/**
+ * What one episode is run with.
+ */
+struct EpisodeJob
+{
+    // replaces the "game" of the config unless null, e.g. {"Create": "Round2"}
+    QJsonValue game;
+    // strategy parameters file for the client, empty for its defaults
+    QString parameters;
+    // the plan's own reference to the job
+    int id = 0;
+};
+
+/**
+ * Decides which episodes the trainer runs and learns how they went.
+ */
+class EpisodePlan
+{
+public:
+    virtual ~EpisodePlan() = default;
+
+    /**
+     * @return Next episode to run, or nothing if there is none until running episodes finish.
+     */
+    virtual std::optional<EpisodeJob> next() = 0;
+    virtual void finished(const EpisodeJob &job, const EpisodeResult &result) = 0;
+    virtual void crashed(const EpisodeJob &job) = 0;
+    /**
+     * @return Whether no more episodes will be run.
+     */
+    virtual bool done() const = 0;
+};
+
+/**
+ * The game of the config with the client's own parameters, again and again.
+ */
+class RepeatPlan : public EpisodePlan
+{
+public:
+    /**
+     * @param episodes Episodes to run, 0 to run until stopped.
+     */
+    explicit RepeatPlan(int episodes);
+
+    std::optional<EpisodeJob> next() override;
+    void finished(const EpisodeJob &, const EpisodeResult &) override {}
+    void crashed(const EpisodeJob &) override {}
+    bool done() const override;
+
+private:
+    const int m_episodes;
+    int m_started = 0;
+};
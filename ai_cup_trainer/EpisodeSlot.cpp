@@ -0,0 +1,210 @@
+#include "EpisodeSlot.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QProcessEnvironment>
+#include <QSet>
+#include <QStringList>
+#include <QTcpServer>
+
+#include <utility>
+
+#include "AtomicWrite.h"
+
+using namespace std;
+
+namespace {
+
+QSet<quint16> usedPorts;
+
+/**
+ * @return Port nothing listens on, other than the ones of the live slots.
+ */
+quint16 freePort()
+{
+    while (true) {
+        QTcpServer server;
+        if (!server.listen(QHostAddress::Any, 0))
+            qFatal("Couldn't find a free port: %s", server.errorString().toStdString().c_str());
+        const auto port = server.serverPort();
+        if (!usedPorts.contains(port)) {
+            usedPorts.insert(port);
+            return port;
+        }
+    }
+}
+
+} // namespace
+
+EpisodeSlot::EpisodeSlot(int index,
+                         const QString &client,
+                         int episodeTimeout,
+                         QObject *parent)
+    : QObject{parent},
+      m_index{index},
+      m_clientScript{client},
+      m_episodeTimeout{episodeTimeout},
+      m_parametersFile{QDir::current().absoluteFilePath(QString{"slot_%1.parameters"}.arg(index))},
+      m_timingFile{QDir::current().absoluteFilePath(QString{"slot_%1.timing"}.arg(index))}
+{
+    auto environment = QProcessEnvironment::systemEnvironment();
+    environment.insert(PARAMETERS_VARIABLE, m_parametersFile);
+    environment.insert(TIMING_VARIABLE, m_timingFile);
+    m_client.setProcessEnvironment(environment);
+    m_client.setProcessChannelMode(QProcess::MergedChannels);
+    m_client.setStandardOutputFile(QString{"client_%1.out"}.arg(m_index), QIODevice::Append);
+    m_timeout.setSingleShot(true);
+
+    connect(&m_server, &QProcess::errorOccurred, this, [](auto error) {
+        if (error == QProcess::FailedToStart) {
+            qFatal("Couldn't start server executable");
+        }
+    });
+    connect(&m_client, &QProcess::errorOccurred, this, [](auto error) {
+        if (error == QProcess::FailedToStart) {
+            qFatal("Couldn't start client executable");
+        }
+    });
+
+    connect(&m_server,
+            &QProcess::finished,
+            this,
+            [this](int exitCode, QProcess::ExitStatus exitStatus) {
+                if (m_stopping || !busy())
+                    return;
+                if (exitStatus == QProcess::CrashExit) {
+                    fail("server crashed");
+                } else if (exitCode != 0) {
+                    fail(QString{"server exited with code %1"}.arg(exitCode));
+                } else {
+                    m_timeout.stop();
+                    emit finished(exchange(m_episode, 0), m_elapsed.elapsed() / 1000.0);
+                }
+            });
+    connect(&m_client,
+            &QProcess::finished,
+            this,
+            [this](int exitCode, QProcess::ExitStatus exitStatus) {
+                if (m_stopping)
+                    return;
+                // a client that plays a single game is started again for the next one
+                if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+                    const auto episode = exchange(m_clientEpisode, 0);
+                    const auto timing = ClientTiming::read(m_timingFile);
+                    QFile::remove(m_timingFile);
+                    startClient();
+                    if (episode != 0 && timing)
+                        emit timed(episode, *timing);
+                    return;
+                }
+                fail(exitStatus == QProcess::CrashExit
+                         ? QString{"client crashed"}
+                         : QString{"client exited with code %1"}.arg(exitCode));
+            });
+    connect(&m_timeout, &QTimer::timeout, this, [this] {
+        fail(QString{"episode didn't finish in %1 s"}.arg(m_episodeTimeout));
+    });
+
+    m_port = freePort();
+    startClient();
+}
+
+EpisodeSlot::~EpisodeSlot()
+{
+    stopProcesses();
+    usedPorts.remove(m_port);
+}
+
+QString EpisodeSlot::directory(int episode)
+{
+    return QString{EPISODE_DIR} + QString::number(episode).rightJustified(6, '0');
+}
+
+void EpisodeSlot::start(int episode, const QJsonObject &config, const QString &parameters)
+{
+    m_episode = episode;
+    m_clientEpisode = episode;
+    QFile::remove(m_timingFile);
+    const auto episodeDir = directory(episode);
+    QDir{}.mkdir(episodeDir);
+    writeParameters(episodeDir, parameters);
+    m_elapsed.start();
+    m_server.start("./bootstrap_server.sh",
+                   {writeConfig(episodeDir, config),
+                    episodeDir.sliced(QString{EPISODE_DIR}.size())});
+    if (m_episodeTimeout > 0)
+        m_timeout.start(m_episodeTimeout * 1000);
+}
+
+void EpisodeSlot::startClient()
+{
+    m_client.start(m_clientScript, {QString::number(m_port)});
+}
+
+void EpisodeSlot::stopProcesses()
+{
+    m_stopping = true;
+    m_timeout.stop();
+    for (auto *process : {&m_server, &m_client}) {
+        if (process->state() != QProcess::NotRunning) {
+            process->kill();
+            process->waitForFinished();
+        }
+    }
+    m_stopping = false;
+}
+
+void EpisodeSlot::fail(const QString &reason)
+{
+    const auto episode = exchange(m_episode, 0);
+    m_clientEpisode = 0;
+    qWarning() << "Slot" << m_index << "recycled:" << reason;
+    stopProcesses();
+    // the old port may still be held by an orphaned process
+    usedPorts.remove(m_port);
+    m_port = freePort();
+    startClient();
+    if (episode != 0)
+        emit crashed(episode, reason);
+}
+
+QString EpisodeSlot::writeConfig(const QString &directory, QJsonObject config) const
+{
+    auto players = config["players"].toArray();
+    for (qsizetype i = 0; i < players.size(); ++i) {
+        auto player = players[i].toObject();
+        if (player.contains("Tcp")) {
+            auto tcp = player["Tcp"].toObject();
+            tcp["port"] = m_port;
+            player["Tcp"] = tcp;
+            players[i] = player;
+            break;
+        }
+    }
+    config["players"] = players;
+
+    const auto path = directory + "/config.json";
+    QFile file{path};
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || file.write(QJsonDocument{config}.toJson()) < 0) {
+        qFatal("Couldn't write \"%s\"", path.toStdString().c_str());
+    }
+    return path;
+}
+
+void EpisodeSlot::writeParameters(const QString &directory, const QString &parameters) const
+{
+    // the client reads the file for every game, an empty one leaves it its defaults, and the copy
+    // in the episode directory is archived with the replay
+    auto paths = QStringList{m_parametersFile};
+    if (!parameters.isEmpty())
+        paths.append(directory + "/parameters");
+    for (const auto &path : paths) {
+        if (!writeAtomically(path, parameters.toUtf8()))
+            qFatal("Couldn't write \"%s\"", path.toStdString().c_str());
+    }
+}
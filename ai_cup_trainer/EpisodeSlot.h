@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QTimer>
+
+#include "ResultAggregator.h"
+
+constexpr auto EPISODE_DIR = "episode_";
+constexpr auto PARAMETERS_VARIABLE = "STRATEGY_PARAMETERS";
+constexpr auto TIMING_VARIABLE = "CLIENT_TIMING";
+
+/**
+ * One client connected to a game server running an episode at a time.
+ *
+ * The slot owns a free port, the client script is started with it and keeps reconnecting to it,
+ * and each episode starts a server on it with its own directory and a copy of the config
+ * pointing to the port. The episode's strategy parameters are written to the file the client's
+ * STRATEGY_PARAMETERS names before the server starts, so the client reads them with the game's
+ * constants. A server
+ * that fails, a client that exits and an episode running past the timeout are crashes: both
+ * processes are killed and the slot is recycled with a new client on a new port.
+ */
+class EpisodeSlot : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param client Script starting a client, with the port as its argument.
+     * @param episodeTimeout Seconds an episode may run, 0 for no limit.
+     */
+    EpisodeSlot(int index,
+                const QString &client,
+                int episodeTimeout,
+                QObject *parent = nullptr);
+    ~EpisodeSlot() override;
+
+    static QString directory(int episode);
+
+    int index() const { return m_index; }
+    bool busy() const { return m_episode != 0; }
+
+    /**
+     * @param parameters Strategy parameters file, empty for the client's defaults.
+     */
+    void start(int episode, const QJsonObject &config, const QString &parameters);
+
+signals:
+    void finished(int episode, double seconds);
+    void crashed(int episode, const QString &reason);
+    /**
+     * The client of @p episode exited after writing the file CLIENT_TIMING names, which may be
+     * before or after the episode finished.
+     */
+    void timed(int episode, const ClientTiming &timing);
+
+private:
+    void startClient();
+    void stopProcesses();
+    void fail(const QString &reason);
+    QString writeConfig(const QString &directory, QJsonObject config) const;
+    void writeParameters(const QString &directory, const QString &parameters) const;
+
+private:
+    const int m_index;
+    const QString m_clientScript;
+    const int m_episodeTimeout;
+    const QString m_parametersFile;
+    const QString m_timingFile;
+
+    quint16 m_port = 0;
+    // 0 when idle
+    int m_episode = 0;
+    // episode the running client plays, it exits after the game while the server may still run
+    int m_clientEpisode = 0;
+    // processes are being killed on purpose
+    bool m_stopping = false;
+
+    QProcess m_server;
+    QProcess m_client;
+    QTimer m_timeout;
+    QElapsedTimer m_elapsed;
+};
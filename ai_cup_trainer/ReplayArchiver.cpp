@@ -0,0 +1,194 @@
+#include "ReplayArchiver.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cmath>
+
+#include "EpisodeSlot.h"
+
+using namespace std;
+
+namespace {
+
+constexpr quint32 MAGIC = 0x45504152; // "EPAR"
+constexpr quint32 VERSION = 1;
+constexpr auto SUFFIX = ".archive";
+constexpr auto CHUNK_SIZE = 4 << 20;
+
+// scores this many standard deviations from the mean are outliers, once there are enough
+constexpr auto OUTLIER_DEVIATIONS = 3.0;
+constexpr auto OUTLIER_MIN_EPISODES = 20;
+
+int episodeOf(const QFileInfo &archive)
+{
+    return archive.completeBaseName().sliced(QString{EPISODE_DIR}.size()).toInt();
+}
+
+} // namespace
+
+ReplayArchiver::ReplayArchiver(QString directory, qint64 limitBytes, QObject *parent)
+    : QObject{parent},
+      m_directory{std::move(directory)},
+      m_limit{limitBytes}
+{
+    m_pool.setMaxThreadCount(1);
+
+    const QDir archives{m_directory};
+    archives.mkpath(KEPT_DIR);
+    const auto filter = QStringList{QString{EPISODE_DIR} + "*" + SUFFIX};
+    for (const auto &info : archives.entryInfoList(filter, QDir::Files, QDir::Name)) {
+        m_archives.emplace_back(info.filePath(), info.size());
+        m_size += info.size();
+        m_lastEpisode = max(m_lastEpisode, episodeOf(info));
+    }
+    const QDir kept{archives.filePath(KEPT_DIR)};
+    for (const auto &info : kept.entryInfoList(filter, QDir::Files, QDir::Name))
+        m_lastEpisode = max(m_lastEpisode, episodeOf(info));
+    // the limit may have been lowered since
+    trim();
+}
+
+ReplayArchiver::~ReplayArchiver()
+{
+    m_pool.waitForDone();
+}
+
+void ReplayArchiver::add(int episode, const EpisodeResult &result)
+{
+    archive(episode, result.crashed || isOutlier(result));
+}
+
+void ReplayArchiver::addCrashed(int episode)
+{
+    archive(episode, true);
+}
+
+bool ReplayArchiver::isOutlier(const EpisodeResult &result)
+{
+    if (!result.score)
+        return false;
+
+    const auto score = *result.score;
+    const auto outlier = m_scores >= OUTLIER_MIN_EPISODES
+                         && abs(score - m_meanScore)
+                                > OUTLIER_DEVIATIONS * sqrt(m_scoreM2 / (m_scores - 1));
+
+    ++m_scores;
+    const auto delta = score - m_meanScore;
+    m_meanScore += delta / m_scores;
+    m_scoreM2 += delta * (score - m_meanScore);
+    return outlier;
+}
+
+void ReplayArchiver::archive(int episode, bool keep)
+{
+    const auto directory = EpisodeSlot::directory(episode);
+    const auto archive = QDir{m_directory}.filePath((keep ? QString{KEPT_DIR} + "/" : QString{})
+                                                    + directory + SUFFIX);
+    m_pool.start([this, directory, archive, keep] {
+        if (!write(directory, archive)) {
+            // the directory stays, nothing is lost
+            qWarning() << "Couldn't archive" << directory << "to" << archive;
+            return;
+        }
+        QDir{directory}.removeRecursively();
+        if (!keep) {
+            QMetaObject::invokeMethod(
+                this, [this, archive] { onArchived(archive); }, Qt::QueuedConnection);
+        }
+    });
+}
+
+void ReplayArchiver::onArchived(const QString &archive)
+{
+    const auto size = QFileInfo{archive}.size();
+    m_archives.emplace_back(archive, size);
+    m_size += size;
+    trim();
+}
+
+void ReplayArchiver::trim()
+{
+    while (m_size > m_limit && !m_archives.empty()) {
+        const auto &[oldest, oldestSize] = m_archives.front();
+        QFile::remove(oldest);
+        m_size -= oldestSize;
+        m_archives.pop_front();
+    }
+}
+
+bool ReplayArchiver::write(const QString &directory, const QString &archive)
+{
+    QSaveFile output{archive};
+    if (!output.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream{&output};
+    stream.setVersion(QDataStream::Qt_5_15);
+    const auto files = QDir{directory}.entryInfoList(QDir::Files, QDir::Name);
+    stream << MAGIC << VERSION << static_cast<quint32>(files.size());
+    for (const auto &info : files) {
+        QFile input{info.filePath()};
+        if (!input.open(QIODevice::ReadOnly))
+            return false;
+        stream << info.fileName() << static_cast<quint64>(info.size());
+        while (!input.atEnd())
+            stream << qCompress(input.read(CHUNK_SIZE));
+        // an empty chunk ends the file
+        stream << QByteArray{};
+    }
+    return stream.status() == QDataStream::Ok && output.commit();
+}
+
+bool ReplayArchiver::extract(const QString &archive, const QString &directory)
+{
+    QFile input{archive};
+    if (!input.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream{&input};
+    stream.setVersion(QDataStream::Qt_5_15);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    stream >> magic >> version >> count;
+    if (magic != MAGIC || version != VERSION || !QDir{}.mkpath(directory))
+        return false;
+
+    for (quint32 i = 0; i < count; ++i) {
+        QString name;
+        quint64 size = 0;
+        stream >> name >> size;
+        // names come from the file, nothing may be written outside the directory
+        if (name.isEmpty() || name == "." || name == ".." || name.contains('/')
+            || name.contains('\\')) {
+            return false;
+        }
+
+        QSaveFile output{QDir{directory}.filePath(name)};
+        if (!output.open(QIODevice::WriteOnly))
+            return false;
+        quint64 written = 0;
+        while (true) {
+            QByteArray chunk;
+            stream >> chunk;
+            if (stream.status() != QDataStream::Ok)
+                return false;
+            if (chunk.isEmpty())
+                break;
+            const auto data = qUncompress(chunk);
+            if (data.isEmpty() || output.write(data) != data.size())
+                return false;
+            written += data.size();
+        }
+        if (written != size || !output.commit())
+            return false;
+    }
+    return true;
+}
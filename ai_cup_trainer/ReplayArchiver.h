@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+
+#include <deque>
+#include <utility>
+
+#include "ResultAggregator.h"
+
+/**
+ * Compresses every finished episode directory into one archive on a background thread and
+ * removes the directory.
+ *
+ * Archives of crashed episodes and of episodes with an outlier score go to `kept/` and are never
+ * removed. The others are removed oldest first once together they take more than the limit.
+ *
+ * An archive holds all files of the directory, each as its name, its size and zlib compressed
+ * chunks, so neither side needs a whole replay in memory.
+ */
+class ReplayArchiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr auto KEPT_DIR = "kept";
+
+    ReplayArchiver(QString directory, qint64 limitBytes, QObject *parent = nullptr);
+    // waits for the archives being written
+    ~ReplayArchiver() override;
+
+    /**
+     * @return Highest episode archived before, 0 if there is none.
+     */
+    int lastEpisode() const { return m_lastEpisode; }
+
+    void add(int episode, const EpisodeResult &result);
+    void addCrashed(int episode);
+
+    /**
+     * Writes the files of @p archive to @p directory.
+     */
+    static bool extract(const QString &archive, const QString &directory);
+
+private:
+    static bool write(const QString &directory, const QString &archive);
+
+    bool isOutlier(const EpisodeResult &result);
+    void archive(int episode, bool keep);
+    void onArchived(const QString &archive);
+    void trim();
+
+private:
+    const QString m_directory;
+    const qint64 m_limit;
+    int m_lastEpisode = 0;
+
+    // archives that may be removed, oldest first, with their sizes
+    std::deque<std::pair<QString, qint64>> m_archives;
+    qint64 m_size = 0;
+
+    // running mean and variance of the score (Welford)
+    qint64 m_scores = 0;
+    double m_meanScore = 0;
+    double m_scoreM2 = 0;
+
+    // one thread, archives are written in episode order
+    QThreadPool m_pool;
+};
@@ -0,0 +1,199 @@
+#include "ResultAggregator.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QMap>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QStringList>
+
+#include <algorithm>
+#include <utility>
+
+#include "AtomicWrite.h"
+
+using namespace std;
+
+namespace {
+
+// columns of the csv for both the total and the recent statistics
+constexpr const char *STATISTICS[] = {"win_rate",
+                                      "score",
+                                      "place",
+                                      "episode_seconds",
+                                      "game_ticks_per_second",
+                                      "client_ms_per_tick"};
+
+optional<double> number(const QJsonValue &value)
+{
+    return value.isDouble() ? optional{value.toDouble()} : nullopt;
+}
+
+/**
+ * @return Entry @p index of the `players` list of @p object, empty if there is none.
+ */
+QJsonObject playerEntry(const QJsonObject &object, int index)
+{
+    const auto players = object["players"].toArray();
+    return index < players.size() ? players[index].toObject() : QJsonObject{};
+}
+
+} // namespace
+
+EpisodeResult EpisodeResult::read(const QString &directory, int playerIndex, double wallSeconds)
+{
+    EpisodeResult result;
+    result.wallSeconds = wallSeconds;
+
+    QFile file{directory + "/result"};
+    if (!file.open(QIODevice::ReadOnly))
+        return result;
+
+    // {"players": [{"crashed": ...}], "results": {"players": [{"score": ..., "place": ...}]}},
+    // the outcome of every player, then the game's results with the same order of players
+    const auto json = QJsonDocument::fromJson(file.readAll()).object();
+    result.crashed = playerEntry(json, playerIndex)["crashed"].toBool();
+    const auto our = playerEntry(json["results"].toObject(), playerIndex);
+    result.score = number(our["score"]);
+    result.place = number(our["place"]);
+    return result;
+}
+
+optional<ClientTiming> ClientTiming::read(const QString &path)
+{
+    QFile file{path};
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return nullopt;
+
+    QMap<QString, double> values;
+    for (const auto &line : QString::fromUtf8(file.readAll()).split('\n', Qt::SkipEmptyParts)) {
+        const auto separator = line.indexOf('=');
+        auto ok = false;
+        const auto value = line.sliced(separator + 1).toDouble(&ok);
+        if (separator > 0 && ok)
+            values[line.left(separator).trimmed()] = value;
+    }
+
+    const auto keys = {"ticks", "game_seconds", "client_seconds"};
+    if (!all_of(begin(keys), end(keys), [&](const char *key) { return values.contains(key); }))
+        return nullopt;
+    return ClientTiming{values["ticks"], values["game_seconds"], values["client_seconds"]};
+}
+
+ResultAggregator::ResultAggregator(QString path, int intervalSeconds, QObject *parent)
+    : QObject{parent},
+      m_path{std::move(path)}
+{
+    m_elapsed.start();
+    connect(&m_timer, &QTimer::timeout, this, &ResultAggregator::write);
+    m_timer.start(intervalSeconds * 1000);
+}
+
+void ResultAggregator::add(const EpisodeResult &result)
+{
+    m_total.add(result);
+    m_recent.add(result);
+    m_recentResults.push_back(result);
+    if (m_recentResults.size() > RECENT_EPISODES) {
+        m_recent.add(m_recentResults.front(), -1);
+        m_recentResults.pop_front();
+    }
+
+    if (result.crashed)
+        ++m_crashes;
+}
+
+void ResultAggregator::addTiming(const ClientTiming &timing)
+{
+    m_total.add(timing);
+    m_recent.add(timing);
+    m_recentTimings.push_back(timing);
+    if (m_recentTimings.size() > RECENT_EPISODES) {
+        m_recent.add(m_recentTimings.front(), -1);
+        m_recentTimings.pop_front();
+    }
+
+    m_ticks += timing.ticks;
+}
+
+void ResultAggregator::addCrash()
+{
+    ++m_crashes;
+}
+
+void ResultAggregator::write() const
+{
+    const auto hours = m_elapsed.elapsed() / 3'600'000.0;
+    const auto seconds = max(hours * 3600, 1e-3);
+
+    auto summary = QJsonObject{};
+    summary["elapsed_seconds"] = qRound64(seconds);
+    summary["episodes"] = m_total.episodes;
+    summary["crashes"] = m_crashes;
+    summary["episodes_per_hour"] = m_total.episodes / max(hours, 1e-6);
+    // game ticks of all slots together
+    summary["ticks_per_second"] = m_ticks / seconds;
+    summary["total"] = m_total.toJson();
+    summary["recent"] = m_recent.toJson();
+    writeAtomically(m_path + ".json", QJsonDocument{summary}.toJson(QJsonDocument::Compact));
+
+    // a header and a single row, the json in a shape spreadsheets and plotting scripts read
+    QStringList header{"elapsed_seconds", "episodes", "crashes", "episodes_per_hour",
+                       "ticks_per_second"};
+    QStringList row;
+    const auto field = [](const QJsonValue &value) {
+        return value.isDouble() ? QString::number(value.toDouble()) : QString{};
+    };
+    for (const auto &key : header)
+        row.append(field(summary[key]));
+    for (const auto *scope : {"total", "recent"}) {
+        const auto statistics = summary[scope].toObject();
+        for (const auto *key : STATISTICS) {
+            header.append(QString{scope} + "_" + key);
+            row.append(field(statistics[key]));
+        }
+    }
+    writeAtomically(m_path + ".csv", (header.join(",") + "\n" + row.join(",") + "\n").toUtf8());
+}
+
+void ResultAggregator::Mean::add(const optional<double> &value, double sign)
+{
+    if (value) {
+        sum += sign * *value;
+        count += static_cast<qint64>(sign);
+    }
+}
+
+QJsonValue ResultAggregator::Mean::value() const
+{
+    return count > 0 ? QJsonValue{sum / count} : QJsonValue{};
+}
+
+void ResultAggregator::Statistics::add(const EpisodeResult &result, double sign)
+{
+    episodes += static_cast<qint64>(sign);
+    wins.add(result.place ? optional{*result.place == 1 ? 1.0 : 0.0} : nullopt, sign);
+    score.add(result.score, sign);
+    place.add(result.place, sign);
+    seconds.add(result.wallSeconds, sign);
+}
+
+void ResultAggregator::Statistics::add(const ClientTiming &timing, double sign)
+{
+    if (timing.ticks <= 0)
+        return;
+    if (timing.gameSeconds > 0)
+        ticksPerSecond.add(timing.ticks / timing.gameSeconds, sign);
+    clientMsPerTick.add(timing.clientSeconds * 1000 / timing.ticks, sign);
+}
+
+QJsonObject ResultAggregator::Statistics::toJson() const
+{
+    return {{"episodes", episodes},
+            {"win_rate", wins.value()},
+            {"score", score.value()},
+            {"place", place.value()},
+            {"episode_seconds", seconds.value()},
+            {"game_ticks_per_second", ticksPerSecond.value()},
+            {"client_ms_per_tick", clientMsPerTick.value()}};
+}
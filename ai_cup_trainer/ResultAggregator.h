@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <deque>
+#include <optional>
+
+/**
+ * What is known about one finished episode of our player.
+ *
+ * The server's result has no tick count or client time, those come with ClientTiming. Values
+ * the server didn't write are missing and left out of the statistics.
+ */
+struct EpisodeResult
+{
+    double wallSeconds = 0;
+    bool crashed = false;
+    std::optional<double> score;
+    std::optional<double> place;
+
+    /**
+     * Reads the `result` file the server saves with --save-results in @p directory.
+     *
+     * @param playerIndex Index of our player in the config's and the result's player lists.
+     */
+    static EpisodeResult read(const QString &directory, int playerIndex, double wallSeconds);
+};
+
+/**
+ * Ticks and time of one game as the client measured them, written to the file CLIENT_TIMING
+ * names when the game finishes. Clients other than bt_impl don't write it.
+ */
+struct ClientTiming
+{
+    double ticks = 0;
+    // from the game's constants to its end
+    double gameSeconds = 0;
+    // spent from decoding a tick to sending its order
+    double clientSeconds = 0;
+
+    /**
+     * @return Timing in the name=value lines at @p path, nothing if the file is missing or
+     * incomplete.
+     */
+    static std::optional<ClientTiming> read(const QString &path);
+};
+
+/**
+ * Running statistics of all finished episodes, and of the last `RECENT_EPISODES` to follow the
+ * training, written to `<path>.json` and `<path>.csv` every interval. Files are replaced
+ * atomically, a reader never sees a partial summary.
+ */
+class ResultAggregator : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr auto RECENT_EPISODES = 100;
+
+    ResultAggregator(QString path, int intervalSeconds, QObject *parent = nullptr);
+
+    void add(const EpisodeResult &result);
+    void addTiming(const ClientTiming &timing);
+    void addCrash();
+    void write() const;
+
+private:
+    struct Mean
+    {
+        double sum = 0;
+        qint64 count = 0;
+
+        void add(const std::optional<double> &value, double sign = 1);
+        QJsonValue value() const;
+    };
+
+    struct Statistics
+    {
+        qint64 episodes = 0;
+        Mean wins;
+        Mean score;
+        Mean place;
+        Mean seconds;
+        Mean ticksPerSecond;
+        Mean clientMsPerTick;
+
+        void add(const EpisodeResult &result, double sign = 1);
+        void add(const ClientTiming &timing, double sign = 1);
+        QJsonObject toJson() const;
+    };
+
+private:
+    const QString m_path;
+    QElapsedTimer m_elapsed;
+    QTimer m_timer;
+
+    Statistics m_total;
+    Statistics m_recent;
+    std::deque<EpisodeResult> m_recentResults;
+    std::deque<ClientTiming> m_recentTimings;
+    qint64 m_crashes = 0;
+    double m_ticks = 0;
+};
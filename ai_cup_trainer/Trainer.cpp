@@ -0,0 +1,102 @@
+#include "Trainer.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QJsonArray>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+auto lastEpisode()
+{
+    QString episodeDir = EPISODE_DIR;
+    const auto episodes = QDir::current().entryList({episodeDir + "*"}, QDir::Dirs, QDir::Name);
+    return episodes.empty() ? 0 : episodes.last().sliced(episodeDir.size()).toInt();
+}
+
+int tcpPlayer(const QJsonObject &config)
+{
+    const auto players = config["players"].toArray();
+    for (qsizetype i = 0; i < players.size(); ++i) {
+        if (players[i].toObject().contains("Tcp"))
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+} // namespace
+
+Trainer::Trainer(Settings settings, unique_ptr<EpisodePlan> plan, QObject *parent)
+    : QObject{parent},
+      m_settings{std::move(settings)},
+      m_plan{std::move(plan)},
+      m_playerIndex{tcpPlayer(m_settings.config)},
+      m_aggregator{m_settings.summaryPath, m_settings.summaryInterval},
+      m_archiver{m_settings.archiveDirectory, m_settings.archiveLimit},
+      m_lastEpisode{max(lastEpisode(), m_archiver.lastEpisode())}
+{}
+
+void Trainer::start()
+{
+    for (int i = 0; i < m_settings.jobs; ++i) {
+        auto slot = make_unique<EpisodeSlot>(i, m_settings.client, m_settings.episodeTimeout);
+        connect(slot.get(), &EpisodeSlot::finished, this, &Trainer::onFinished);
+        connect(slot.get(), &EpisodeSlot::crashed, this, &Trainer::onCrashed);
+        connect(slot.get(), &EpisodeSlot::timed, this, [this](int, const ClientTiming &timing) {
+            m_aggregator.addTiming(timing);
+        });
+        m_slots.push_back(std::move(slot));
+    }
+    startIdle();
+}
+
+void Trainer::startIdle()
+{
+    // a plan may have nothing for a slot until other episodes finished, so every slot is offered
+    // the next episode whenever any episode ends
+    for (auto &slot : m_slots) {
+        if (slot->busy())
+            continue;
+        auto job = m_plan->next();
+        if (!job)
+            break;
+
+        auto config = m_settings.config;
+        if (!job->game.isNull())
+            config["game"] = job->game;
+        qInfo() << "Starting episode" << ++m_lastEpisode << "in slot" << slot->index();
+        slot->start(m_lastEpisode, config, job->parameters);
+        m_jobs.emplace(m_lastEpisode, std::move(*job));
+    }
+
+    if (m_jobs.empty() && m_plan->done()) {
+        m_aggregator.write();
+        emit done();
+    }
+}
+
+void Trainer::onFinished(int episode, double seconds)
+{
+    const auto directory = EpisodeSlot::directory(episode);
+    const auto result = EpisodeResult::read(directory, m_playerIndex, seconds);
+    m_aggregator.add(result);
+    m_archiver.add(episode, result);
+
+    const auto job = m_jobs.extract(episode);
+    m_plan->finished(job.mapped(), result);
+    startIdle();
+}
+
+void Trainer::onCrashed(int episode, const QString &reason)
+{
+    qWarning() << "Episode" << episode << "crashed:" << reason;
+    m_aggregator.addCrash();
+    m_archiver.addCrashed(episode);
+
+    const auto job = m_jobs.extract(episode);
+    m_plan->crashed(job.mapped());
+    startIdle();
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "EpisodePlan.h"
+#include "EpisodeSlot.h"
+#include "ReplayArchiver.h"
+#include "ResultAggregator.h"
+
+/**
+ * Runs the episodes of a plan in a fixed number of slots, each slot takes the next episode as
+ * soon as its previous one finished or crashed.
+ *
+ * Episodes are numbered on from the last episode directory or archive.
+ */
+class Trainer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Settings
+    {
+        QJsonObject config;
+        // script starting a client with the port as its argument
+        QString client = "./bootstrap_client.sh";
+        int jobs = 1;
+        // seconds, 0 for no limit
+        int episodeTimeout = 0;
+        // summary files without extension
+        QString summaryPath = "summary";
+        int summaryInterval = 10;
+        QString archiveDirectory = "archives";
+        qint64 archiveLimit = qint64{10} << 30;
+    };
+
+    Trainer(Settings settings, std::unique_ptr<EpisodePlan> plan, QObject *parent = nullptr);
+
+    void start();
+
+signals:
+    /**
+     * All episodes of the plan ran.
+     */
+    void done();
+
+private:
+    void startIdle();
+    void onFinished(int episode, double seconds);
+    void onCrashed(int episode, const QString &reason);
+
+private:
+    const Settings m_settings;
+    const std::unique_ptr<EpisodePlan> m_plan;
+    // of our player in the config and the results
+    const int m_playerIndex;
+    ResultAggregator m_aggregator;
+    ReplayArchiver m_archiver;
+    std::vector<std::unique_ptr<EpisodeSlot>> m_slots;
+    // running episodes
+    std::map<int, EpisodeJob> m_jobs;
+    int m_lastEpisode;
+};
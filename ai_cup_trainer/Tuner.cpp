@@ -0,0 +1,524 @@
+#include "Tuner.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QProcess>
+#include <QStringList>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "AtomicWrite.h"
+
+using namespace std;
+
+namespace {
+
+// seconds the client may take to list its parameters
+constexpr auto LIST_PARAMETERS_TIMEOUT = 10;
+
+using Matrix = vector<vector<double>>;
+
+/**
+ * @return Value of "game" in the server config that creates @p preset.
+ */
+QJsonObject presetGame(const QString &preset)
+{
+    static const QJsonObject names{{"round1", "Round1"},
+                                   {"round2", "Round2"},
+                                   {"finals", "Finals"}};
+    return {{"Create", names.contains(preset) ? names[preset] : QJsonValue{preset}}};
+}
+
+/**
+ * @return 97.5% quantile of Student's t distribution, the half width of a 95% confidence
+ * interval in standard errors.
+ */
+double tQuantile(int degreesOfFreedom)
+{
+    constexpr double TABLE[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                                2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                                2.110,  2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                                2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+    return degreesOfFreedom <= static_cast<int>(size(TABLE)) ? TABLE[degreesOfFreedom - 1] : 1.96;
+}
+
+struct Summary
+{
+    int count = 0;
+    double mean = 0;
+    double deviation = 0;
+};
+
+Summary summarize(const vector<double> &values)
+{
+    Summary summary;
+    summary.count = static_cast<int>(values.size());
+    if (summary.count == 0)
+        return summary;
+    summary.mean = accumulate(cbegin(values), cend(values), 0.0) / summary.count;
+    if (summary.count > 1) {
+        auto squares = 0.0;
+        for (const auto value : values)
+            squares += (value - summary.mean) * (value - summary.mean);
+        summary.deviation = sqrt(squares / (summary.count - 1));
+    }
+    return summary;
+}
+
+/**
+ * Eigen decomposition of the symmetric @p matrix by Jacobi rotations, plenty for a handful of
+ * parameters. Eigenvector i is column i of @p vectors.
+ */
+void eigen(Matrix matrix, Matrix &vectors, vector<double> &values)
+{
+    const auto n = matrix.size();
+    vectors.assign(n, vector<double>(n, 0));
+    for (size_t i = 0; i < n; ++i)
+        vectors[i][i] = 1;
+
+    for (int sweep = 0; sweep < 100; ++sweep) {
+        auto offDiagonal = 0.0;
+        for (size_t p = 0; p < n; ++p) {
+            for (size_t q = p + 1; q < n; ++q)
+                offDiagonal += matrix[p][q] * matrix[p][q];
+        }
+        if (offDiagonal < 1e-30)
+            break;
+
+        for (size_t p = 0; p < n; ++p) {
+            for (size_t q = p + 1; q < n; ++q) {
+                if (matrix[p][q] == 0)
+                    continue;
+                const auto theta = (matrix[q][q] - matrix[p][p]) / (2 * matrix[p][q]);
+                const auto t = (theta >= 0 ? 1 : -1) / (abs(theta) + sqrt(theta * theta + 1));
+                const auto c = 1 / sqrt(t * t + 1);
+                const auto s = t * c;
+                const auto rotate = [c, s](double &first, double &second) {
+                    const auto oldFirst = first;
+                    first = c * oldFirst - s * second;
+                    second = s * oldFirst + c * second;
+                };
+                for (size_t k = 0; k < n; ++k)
+                    rotate(matrix[k][p], matrix[k][q]);
+                for (size_t k = 0; k < n; ++k)
+                    rotate(matrix[p][k], matrix[q][k]);
+                for (size_t k = 0; k < n; ++k)
+                    rotate(vectors[k][p], vectors[k][q]);
+            }
+        }
+    }
+
+    values.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        values[i] = matrix[i][i];
+}
+
+/**
+ * @return Names of the strategy parameters the @p client script prints as `name = value` lines
+ * with --list-parameters, nothing if it fails to.
+ */
+optional<QStringList> clientParameters(const QString &client)
+{
+    QProcess process;
+    process.start(client, {"--list-parameters"});
+    if (!process.waitForFinished(LIST_PARAMETERS_TIMEOUT * 1000)
+        || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        process.kill();
+        process.waitForFinished();
+        return nullopt;
+    }
+
+    QStringList names;
+    const auto output = QString::fromUtf8(process.readAllStandardOutput());
+    for (const auto &line : output.split('\n', Qt::SkipEmptyParts)) {
+        const auto separator = line.indexOf('=');
+        if (separator > 0)
+            names.append(line.left(separator).trimmed());
+    }
+    return names;
+}
+
+double norm(const vector<double> &vector)
+{
+    return sqrt(inner_product(cbegin(vector), cend(vector), cbegin(vector), 0.0));
+}
+
+} // namespace
+
+unique_ptr<Tuner> Tuner::load(const QString &specFile, QString reportPath, const QString &client)
+{
+    QFile file{specFile};
+    if (!file.open(QIODevice::ReadOnly))
+        qFatal("Tuning spec \"%s\" not found.", specFile.toStdString().c_str());
+
+    QJsonParseError error;
+    const auto document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        qFatal("Tuning spec \"%s\" isn't a JSON object: %s",
+               specFile.toStdString().c_str(),
+               error.errorString().toStdString().c_str());
+    }
+
+    const auto names = clientParameters(client);
+    if (!names || names->isEmpty()) {
+        qFatal("Client \"%s\" doesn't list strategy parameters with --list-parameters, tune with "
+               "--client bootstrap_bt_client.sh.",
+               client.toStdString().c_str());
+    }
+    const auto parameters = document.object().value("parameters").toObject();
+    for (auto it = parameters.begin(); it != parameters.end(); ++it) {
+        if (!names->contains(it.key())) {
+            qFatal("Client \"%s\" has no strategy parameter %s, it has %s.",
+                   client.toStdString().c_str(),
+                   it.key().toStdString().c_str(),
+                   names->join(", ").toStdString().c_str());
+        }
+    }
+    return unique_ptr<Tuner>{new Tuner{document.object(), std::move(reportPath)}};
+}
+
+Tuner::Tuner(QJsonObject spec, QString reportPath)
+    : m_reportPath{std::move(reportPath)},
+      m_random{static_cast<uint64_t>(spec.value("seed").toInt(1))}
+{
+    const auto method = spec.value("method").toString();
+    if (method != "sweep" && method != "cmaes")
+        qFatal("Tuning method must be \"sweep\" or \"cmaes\".");
+    m_cmaes = method == "cmaes";
+
+    auto presets = spec.value("presets").toArray();
+    if (presets.isEmpty())
+        presets = QJsonArray{"round1", "round2", "finals"};
+    for (const auto &preset : presets)
+        m_presets.append(preset.toString());
+    m_episodes = max(spec.value("episodes").toInt(1), 1);
+
+    const auto parameters = spec.value("parameters").toObject();
+    for (auto it = parameters.begin(); it != parameters.end(); ++it) {
+        const auto range = it.value().toObject();
+        auto parameter = Parameter{it.key(),
+                                   range["min"].toDouble(),
+                                   range["max"].toDouble(),
+                                   max(range["steps"].toInt(3), 1)};
+        if (!(parameter.max > parameter.min))
+            qFatal("Tuned parameter %s needs min < max.", it.key().toStdString().c_str());
+        const auto start = range["start"].toDouble((parameter.min + parameter.max) / 2);
+        parameter.start = clamp((start - parameter.min) / (parameter.max - parameter.min),
+                                0.0,
+                                1.0);
+        m_parameters.push_back(parameter);
+    }
+    if (m_presets.isEmpty() || m_parameters.empty())
+        qFatal("Tuning needs at least one preset and one parameter.");
+
+    const auto n = m_parameters.size();
+    if (!m_cmaes) {
+        auto count = size_t{1};
+        for (const auto &parameter : m_parameters)
+            count *= parameter.steps;
+        for (size_t index = 0; index < count; ++index) {
+            vector<double> point;
+            auto rest = index;
+            for (const auto &parameter : m_parameters) {
+                const auto step = static_cast<int>(rest % parameter.steps);
+                rest /= parameter.steps;
+                point.push_back(parameter.steps == 1 ? parameter.start
+                                                     : double(step) / (parameter.steps - 1));
+            }
+            addCandidate(std::move(point));
+        }
+        return;
+    }
+
+    m_generations = max(spec.value("generations").toInt(10), 1);
+    m_population = max(spec.value("population").toInt(4 + static_cast<int>(3 * log(n))), 2);
+    m_sigma = spec.value("sigma").toDouble(0.3);
+    for (const auto &parameter : m_parameters)
+        m_mean.push_back(parameter.start);
+    m_covariance.assign(n, vector<double>(n, 0));
+    for (size_t i = 0; i < n; ++i)
+        m_covariance[i][i] = 1;
+    eigen(m_covariance, m_eigenvectors, m_eigenvalues);
+    m_sigmaPath.assign(n, 0);
+    m_covariancePath.assign(n, 0);
+    sample();
+}
+
+optional<EpisodeJob> Tuner::next()
+{
+    if (m_queue.empty())
+        return nullopt;
+
+    const auto id = m_queue.front();
+    m_queue.pop_front();
+    const auto &job = m_jobs[id];
+    return EpisodeJob{presetGame(m_presets[job.preset]),
+                      parameters(m_candidates[job.candidate]),
+                      id};
+}
+
+void Tuner::finished(const EpisodeJob &job, const EpisodeResult &result)
+{
+    const auto &tunerJob = m_jobs[job.id];
+    auto &candidate = m_candidates[tunerJob.candidate];
+    if (result.score)
+        candidate.scores[tunerJob.preset].push_back(*result.score);
+    if (result.crashed || !result.score)
+        ++candidate.crashes;
+    jobDone();
+}
+
+void Tuner::crashed(const EpisodeJob &job)
+{
+    // the slot crashed, not necessarily the candidate, so it gets a few more tries
+    auto &tunerJob = m_jobs[job.id];
+    if (++tunerJob.attempts < MAX_ATTEMPTS) {
+        m_queue.push_front(job.id);
+        return;
+    }
+    ++m_candidates[tunerJob.candidate].crashes;
+    jobDone();
+}
+
+bool Tuner::done() const
+{
+    return m_queue.empty() && m_outstanding == 0;
+}
+
+double Tuner::Candidate::mean() const
+{
+    auto sum = 0.0;
+    auto count = 0;
+    for (const auto &preset : scores) {
+        sum += accumulate(cbegin(preset), cend(preset), 0.0);
+        count += static_cast<int>(preset.size());
+    }
+    return count > 0 ? sum / count : -numeric_limits<double>::infinity();
+}
+
+void Tuner::addCandidate(vector<double> point)
+{
+    const auto index = static_cast<int>(m_candidates.size());
+    m_candidates.push_back(Candidate{m_generation,
+                                     std::move(point),
+                                     vector<vector<double>>(m_presets.size())});
+    for (int preset = 0; preset < m_presets.size(); ++preset) {
+        for (int episode = 0; episode < m_episodes; ++episode) {
+            m_queue.push_back(static_cast<int>(m_jobs.size()));
+            m_jobs.push_back(Job{index, preset});
+            ++m_outstanding;
+        }
+    }
+}
+
+void Tuner::sample()
+{
+    const auto n = m_parameters.size();
+    normal_distribution<double> normal;
+    m_firstOfGeneration = m_candidates.size();
+    for (int k = 0; k < m_population; ++k) {
+        vector<double> scaled(n);
+        for (size_t i = 0; i < n; ++i)
+            scaled[i] = sqrt(max(m_eigenvalues[i], 0.0)) * normal(m_random);
+        vector<double> point = m_mean;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j)
+                point[i] += m_sigma * m_eigenvectors[i][j] * scaled[j];
+            // the clipped point is the one evaluated and used in the update
+            point[i] = clamp(point[i], 0.0, 1.0);
+        }
+        addCandidate(std::move(point));
+    }
+}
+
+void Tuner::update()
+{
+    // (mu/mu_w, lambda)-CMA-ES, Hansen's tutorial notation
+    const auto n = static_cast<double>(m_parameters.size());
+    const auto dimensions = m_parameters.size();
+    const auto mu = max(m_population / 2, 1);
+
+    vector<double> weights(mu);
+    for (int i = 0; i < mu; ++i)
+        weights[i] = log(mu + 0.5) - log(i + 1.0);
+    const auto weightSum = accumulate(cbegin(weights), cend(weights), 0.0);
+    for (auto &weight : weights)
+        weight /= weightSum;
+    const auto muEff = 1 / inner_product(cbegin(weights), cend(weights), cbegin(weights), 0.0);
+
+    const auto cSigma = (muEff + 2) / (n + muEff + 5);
+    const auto dSigma = 1 + 2 * max(0.0, sqrt((muEff - 1) / (n + 1)) - 1) + cSigma;
+    const auto cC = (4 + muEff / n) / (n + 4 + 2 * muEff / n);
+    const auto c1 = 2 / ((n + 1.3) * (n + 1.3) + muEff);
+    const auto cMu = min(1 - c1, 2 * (muEff - 2 + 1 / muEff) / ((n + 2) * (n + 2) + muEff));
+    const auto chiN = sqrt(n) * (1 - 1 / (4 * n) + 1 / (21 * n * n));
+
+    // best first
+    vector<size_t> order(m_population);
+    iota(begin(order), end(order), m_firstOfGeneration);
+    stable_sort(begin(order), end(order), [this](size_t left, size_t right) {
+        return m_candidates[left].mean() > m_candidates[right].mean();
+    });
+
+    Matrix steps(mu, vector<double>(dimensions));
+    vector<double> meanStep(dimensions, 0);
+    for (int i = 0; i < mu; ++i) {
+        for (size_t d = 0; d < dimensions; ++d) {
+            steps[i][d] = (m_candidates[order[i]].point[d] - m_mean[d]) / m_sigma;
+            meanStep[d] += weights[i] * steps[i][d];
+        }
+    }
+    for (size_t d = 0; d < dimensions; ++d)
+        m_mean[d] += m_sigma * meanStep[d];
+
+    // C^-1/2 * meanStep
+    vector<double> whitened(dimensions, 0);
+    for (size_t j = 0; j < dimensions; ++j) {
+        auto projection = 0.0;
+        for (size_t d = 0; d < dimensions; ++d)
+            projection += m_eigenvectors[d][j] * meanStep[d];
+        projection /= sqrt(max(m_eigenvalues[j], 1e-20));
+        for (size_t d = 0; d < dimensions; ++d)
+            whitened[d] += m_eigenvectors[d][j] * projection;
+    }
+
+    for (size_t d = 0; d < dimensions; ++d) {
+        m_sigmaPath[d] = (1 - cSigma) * m_sigmaPath[d]
+                         + sqrt(cSigma * (2 - cSigma) * muEff) * whitened[d];
+    }
+    const auto sigmaPathNorm = norm(m_sigmaPath);
+    const auto hSigma = sigmaPathNorm / sqrt(1 - pow(1 - cSigma, 2 * (m_generation + 1)))
+                                < (1.4 + 2 / (n + 1)) * chiN
+                            ? 1.0
+                            : 0.0;
+    for (size_t d = 0; d < dimensions; ++d) {
+        m_covariancePath[d] = (1 - cC) * m_covariancePath[d]
+                              + hSigma * sqrt(cC * (2 - cC) * muEff) * meanStep[d];
+    }
+
+    for (size_t i = 0; i < dimensions; ++i) {
+        for (size_t j = 0; j < dimensions; ++j) {
+            auto rankMu = 0.0;
+            for (int k = 0; k < mu; ++k)
+                rankMu += weights[k] * steps[k][i] * steps[k][j];
+            m_covariance[i][j] = (1 - c1 - cMu) * m_covariance[i][j]
+                                 + c1
+                                       * (m_covariancePath[i] * m_covariancePath[j]
+                                          + (1 - hSigma) * cC * (2 - cC) * m_covariance[i][j])
+                                 + cMu * rankMu;
+        }
+    }
+
+    // a step beyond the whole range samples nothing but its edges
+    m_sigma = min(m_sigma * exp(cSigma / dSigma * (sigmaPathNorm / chiN - 1)), 1.0);
+    eigen(m_covariance, m_eigenvectors, m_eigenvalues);
+}
+
+void Tuner::jobDone()
+{
+    --m_outstanding;
+    if (m_cmaes && m_outstanding == 0) {
+        update();
+        if (++m_generation < m_generations)
+            sample();
+    }
+    writeReport();
+}
+
+QString Tuner::parameters(const Candidate &candidate) const
+{
+    QString text;
+    for (size_t i = 0; i < m_parameters.size(); ++i) {
+        const auto &parameter = m_parameters[i];
+        const auto value = parameter.min + candidate.point[i] * (parameter.max - parameter.min);
+        text += parameter.name + " = " + QString::number(value, 'g', 17) + "\n";
+    }
+    return text;
+}
+
+void Tuner::writeReport() const
+{
+    vector<size_t> order(m_candidates.size());
+    iota(begin(order), end(order), size_t{0});
+    stable_sort(begin(order), end(order), [this](size_t left, size_t right) {
+        return m_candidates[left].mean() > m_candidates[right].mean();
+    });
+
+    QJsonArray candidates;
+    QStringList csv;
+    {
+        QStringList header{"rank", "generation"};
+        for (const auto &parameter : m_parameters)
+            header.append(parameter.name);
+        header << "episodes" << "crashes" << "mean_score" << "ci95_low" << "ci95_high";
+        for (const auto &preset : m_presets)
+            header.append(preset + "_mean_score");
+        csv.append(header.join(","));
+    }
+
+    for (size_t rank = 0; rank < order.size(); ++rank) {
+        const auto &candidate = m_candidates[order[rank]];
+        const auto position = static_cast<int>(rank + 1);
+        vector<double> all;
+        QJsonObject presets;
+        QStringList presetMeans;
+        for (int preset = 0; preset < m_presets.size(); ++preset) {
+            const auto &scores = candidate.scores[preset];
+            all.insert(end(all), cbegin(scores), cend(scores));
+            const auto summary = summarize(scores);
+            presets[m_presets[preset]] = QJsonObject{
+                {"episodes", summary.count},
+                {"mean_score", summary.count > 0 ? QJsonValue{summary.mean} : QJsonValue{}}};
+            presetMeans.append(summary.count > 0 ? QString::number(summary.mean) : QString{});
+        }
+
+        const auto summary = summarize(all);
+        const auto halfWidth = summary.count > 1 ? tQuantile(summary.count - 1)
+                                                       * summary.deviation / sqrt(summary.count)
+                                                 : numeric_limits<double>::quiet_NaN();
+        const auto number = [](double value) {
+            return isfinite(value) ? QJsonValue{value} : QJsonValue{};
+        };
+        const auto text = [](double value) {
+            return isfinite(value) ? QString::number(value) : QString{};
+        };
+
+        QJsonObject values;
+        QStringList row{QString::number(position), QString::number(candidate.generation)};
+        for (size_t i = 0; i < m_parameters.size(); ++i) {
+            const auto &parameter = m_parameters[i];
+            const auto value = parameter.min + candidate.point[i] * (parameter.max - parameter.min);
+            values[parameter.name] = value;
+            row.append(QString::number(value, 'g', 17));
+        }
+        const auto mean = summary.count > 0 ? summary.mean : numeric_limits<double>::quiet_NaN();
+        row << QString::number(summary.count) << QString::number(candidate.crashes) << text(mean)
+            << text(mean - halfWidth) << text(mean + halfWidth);
+        row.append(presetMeans);
+        csv.append(row.join(","));
+
+        candidates.append(QJsonObject{{"rank", position},
+                                      {"generation", candidate.generation},
+                                      {"parameters", values},
+                                      {"episodes", summary.count},
+                                      {"crashes", candidate.crashes},
+                                      {"mean_score", number(mean)},
+                                      {"ci95_low", number(mean - halfWidth)},
+                                      {"ci95_high", number(mean + halfWidth)},
+                                      {"presets", presets}});
+    }
+
+    QJsonObject report{{"method", m_cmaes ? "cmaes" : "sweep"},
+                       {"done", done()},
+                       {"candidates", candidates}};
+    if (m_cmaes) {
+        report["generation"] = m_generation;
+        report["sigma"] = m_sigma;
+    }
+    writeAtomically(m_reportPath + ".json", QJsonDocument{report}.toJson(QJsonDocument::Compact));
+    writeAtomically(m_reportPath + ".csv", (csv.join("\n") + "\n").toUtf8());
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "EpisodePlan.h"
+
+/**
+ * Searches strategy parameters for the best mean score over a set of game presets, either on a
+ * grid (sweep) or with CMA-ES.
+ *
+ * Every candidate set plays `episodes` episodes of every preset, its score is the mean over all
+ * of them. After every result all candidates are written to `<report>.json` and `<report>.csv`,
+ * best first, with the 95% confidence interval of the mean.
+ *
+ * The search is described by a JSON file:
+ *
+ *     {
+ *         "method": "cmaes",              // or "sweep"
+ *         "presets": ["round1", "round2", "finals"],
+ *         "episodes": 4,                  // per candidate and preset
+ *         "parameters": {
+ *             "shoot_range_ratio": {"min": 0.3, "max": 1.0, "steps": 5},
+ *             "cos_threshold": {"min": 0.9, "max": 0.999, "start": 0.99}
+ *         },
+ *         "generations": 10,              // cmaes only
+ *         "population": 8,                // cmaes only, by default 4 + 3 ln(parameters)
+ *         "sigma": 0.3,                   // cmaes only, initial step in units of the ranges
+ *         "seed": 1
+ *     }
+ *
+ * Sweeps use `steps` values of each parameter, CMA-ES starts at `start` or in the middle.
+ */
+class Tuner : public EpisodePlan
+{
+public:
+    /**
+     * @param client Script starting the tuned client, run with --list-parameters instead of a port
+     * to get the names of the strategy parameters it takes.
+     * @return Tuner described by @p specFile, exits with a message if the file is invalid or
+     * names a parameter the client doesn't take.
+     */
+    static std::unique_ptr<Tuner> load(const QString &specFile,
+                                       QString reportPath,
+                                       const QString &client);
+
+    std::optional<EpisodeJob> next() override;
+    void finished(const EpisodeJob &job, const EpisodeResult &result) override;
+    void crashed(const EpisodeJob &job) override;
+    bool done() const override;
+
+private:
+    static constexpr auto MAX_ATTEMPTS = 3;
+
+    struct Parameter
+    {
+        QString name;
+        double min = 0;
+        double max = 1;
+        int steps = 1;
+        double start = 0.5;
+    };
+
+    struct Candidate
+    {
+        int generation = 0;
+        // in units of the parameter ranges, 0 at min and 1 at max
+        std::vector<double> point;
+        // per preset
+        std::vector<std::vector<double>> scores;
+        int crashes = 0;
+
+        double mean() const;
+    };
+
+    struct Job
+    {
+        int candidate;
+        int preset;
+        int attempts = 0;
+    };
+
+    Tuner(QJsonObject spec, QString reportPath);
+
+    void addCandidate(std::vector<double> point);
+    void sample();
+    void update();
+    void jobDone();
+    QString parameters(const Candidate &candidate) const;
+    void writeReport() const;
+
+private:
+    const QString m_reportPath;
+    bool m_cmaes = false;
+    QStringList m_presets;
+    int m_episodes = 1;
+    std::vector<Parameter> m_parameters;
+
+    std::vector<Candidate> m_candidates;
+    std::vector<Job> m_jobs;
+    std::deque<int> m_queue;
+    // jobs of the current generation not finished yet
+    int m_outstanding = 0;
+
+    // CMA-ES state, in units of the parameter ranges
+    int m_generations = 0;
+    int m_generation = 0;
+    int m_population = 0;
+    size_t m_firstOfGeneration = 0;
+    double m_sigma = 0.3;
+    std::vector<double> m_mean;
+    std::vector<std::vector<double>> m_covariance;
+    std::vector<std::vector<double>> m_eigenvectors;
+    std::vector<double> m_eigenvalues;
+    std::vector<double> m_sigmaPath;
+    std::vector<double> m_covariancePath;
+    std::mt19937_64 m_random;
+};
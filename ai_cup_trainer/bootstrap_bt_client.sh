@@ -0,0 +1,9 @@
+#!/bin/bash
+
+# positional arguments: 1 - port number, or --list-parameters to print the strategy parameters
+# the client reads its parameters from the file STRATEGY_PARAMETERS names, so it can be tuned
+
+BUILD_DIR=${BT_IMPL_BUILD_DIR:-../bt_impl/build}
+
+# exec, so that killing the script kills the client and frees its connection
+exec $BUILD_DIR/ai_cup_22 localhost $1
@@ -1,8 +1,8 @@
 #!/bin/bash
 
-# positional arguments: 1 - port number, 2 - episode number
+# positional arguments: 1 - port number
 
 PROJECT_DIR=../rl_impl
 
 source $PROJECT_DIR/venv/bin/activate
-python $PROJECT_DIR/main.py localhost $1
+exec python $PROJECT_DIR/main.py localhost $1
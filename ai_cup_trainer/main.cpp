@@ -6,28 +6,27 @@
  *************************************************************************/
 
 #include <QCoreApplication>
-#include <QProcess>
-#include <QDir>
-#include <QString>
 #include <QCommandLineParser>
-#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+#include <QThread>
 
-using namespace std;
+#include <algorithm>
+#include <memory>
 
-constexpr auto EPISODE_DIR = "episode_";
+#include "EpisodePlan.h"
+#include "ReplayArchiver.h"
+#include "Trainer.h"
+#include "Tuner.h"
 
-auto lastEpisode()
-{
-    QString episodeDir = EPISODE_DIR;
-    const auto episodes = QDir::current().entryList({episodeDir + "*"}, QDir::Dirs, QDir::Name);
-    return episodes.empty() ? 0 : episodes.last().sliced(episodeDir.size()).toInt();
-}
+using namespace std;
 
 int main(int argc, char *argv[])
 {
-    auto currentEpisode = lastEpisode();
-    auto lastEpisodeDir = QString{};
-
     QCoreApplication a(argc, argv);
     QCoreApplication::setApplicationName("ai_cup_trainer");
     QCoreApplication::setApplicationVersion("1.0");
@@ -36,52 +35,127 @@ int main(int argc, char *argv[])
                                                  "Set a configuration file for server.",
                                                  "file",
                                                  "config.json"};
+    const auto clientOption = QCommandLineOption{"client",
+                                                 "Start clients with <script>, which gets the "
+                                                 "port as its argument.",
+                                                 "script",
+                                                 "bootstrap_client.sh"};
+    const auto jobsOption = QCommandLineOption{{"j", "jobs"},
+                                               "Run <n> episodes at once, 0 for one per core.",
+                                               "n",
+                                               "1"};
+    const auto episodesOption = QCommandLineOption{"episodes",
+                                                   "Stop after <n> episodes, 0 to run until "
+                                                   "stopped.",
+                                                   "n",
+                                                   "0"};
+    const auto timeoutOption = QCommandLineOption{"episode-timeout",
+                                                  "Recycle a slot whose episode runs longer than "
+                                                  "<seconds>, 0 for no limit.",
+                                                  "seconds",
+                                                  "0"};
+    const auto summaryOption = QCommandLineOption{"summary",
+                                                  "Write statistics of the finished episodes to "
+                                                  "<path>.json and <path>.csv.",
+                                                  "path",
+                                                  "summary"};
+    const auto archivesOption = QCommandLineOption{"archives",
+                                                   "Archive finished episodes to <directory>.",
+                                                   "directory",
+                                                   "archives"};
+    const auto archiveLimitOption = QCommandLineOption{"archive-limit",
+                                                       "Remove the oldest archives beyond <MiB>, "
+                                                       "failures and outliers are always kept.",
+                                                       "MiB",
+                                                       "10240"};
+    const auto extractOption = QCommandLineOption{"extract",
+                                                  "Extract <archive> to a directory of the same "
+                                                  "name and exit.",
+                                                  "archive"};
+    const auto tuneOption = QCommandLineOption{"tune",
+                                               "Search strategy parameters as described by "
+                                               "<spec> instead of repeating the config's game.",
+                                               "spec"};
+    const auto tuneReportOption = QCommandLineOption{"tune-report",
+                                                     "Write the tuning results to <path>.json "
+                                                     "and <path>.csv.",
+                                                     "path",
+                                                     "tuning"};
+    const auto summaryIntervalOption = QCommandLineOption{"summary-interval",
+                                                          "Rewrite the summary every <seconds>.",
+                                                          "seconds",
+                                                          "10"};
 
     QCommandLineParser parser;
     parser.setApplicationDescription(
         "Uses ai cup game server and client to train Q-Network continuously");
     parser.addHelpOption();
     parser.addVersionOption();
-    parser.addOptions({configOption});
+    parser.addOptions({configOption,
+                       clientOption,
+                       jobsOption,
+                       episodesOption,
+                       timeoutOption,
+                       summaryOption,
+                       summaryIntervalOption,
+                       archivesOption,
+                       archiveLimitOption,
+                       extractOption,
+                       tuneOption,
+                       tuneReportOption});
     parser.process(a);
 
+    if (parser.isSet(extractOption)) {
+        const auto archive = parser.value(extractOption);
+        const auto directory = QFileInfo{archive}.completeBaseName();
+        if (!ReplayArchiver::extract(archive, directory))
+            qFatal("Couldn't extract \"%s\"", archive.toStdString().c_str());
+        return 0;
+    }
+
     const auto configFile = parser.value(configOption);
-    if (!QFile::exists(configFile)) {
+    QFile file{configFile};
+    if (!file.open(QIODevice::ReadOnly)) {
         qFatal("Config file \"%s\" not found.",
                configFile.toStdString().c_str());
     }
+    const auto config = QJsonDocument::fromJson(file.readAll()).object();
+    const auto players = config["players"].toArray();
+    if (none_of(cbegin(players), cend(players), [](const auto &player) {
+            return player.toObject().contains("Tcp");
+        })) {
+        qFatal("Config file \"%s\" has no Tcp player for the client.",
+               configFile.toStdString().c_str());
+    }
 
-    QProcess serverProcess;
-    QProcess clientProcess;
-    clientProcess.setProcessChannelMode(QProcess::ForwardedChannels);
-
-    const auto tryStartSimulation = [&] {
-        if (serverProcess.state() == QProcess::NotRunning) {
-            if (currentEpisode % 50 != 0 && !lastEpisodeDir.isEmpty()) {
-                QDir{lastEpisodeDir}.removeRecursively();
-            }
-            qInfo() << "Starting episode" << ++currentEpisode;
-            const auto episodeStr = QString::number(currentEpisode).rightJustified(6, '0');
-            lastEpisodeDir = QString{EPISODE_DIR} + episodeStr;
-            QDir{}.mkdir(lastEpisodeDir);
-            serverProcess.start("./bootstrap_server.sh", {configFile, episodeStr});
-        }
-    };
+    const auto client = QFileInfo{parser.value(clientOption)};
+    if (!client.isExecutable()) {
+        qFatal("Client script \"%s\" isn't executable.",
+               parser.value(clientOption).toStdString().c_str());
+    }
 
-    QObject::connect(&serverProcess, &QProcess::errorOccurred, &a, [&](auto error) {
-        if (error == QProcess::FailedToStart) {
-            qFatal("Couldn't start server executable");
-        }
-    });
-    QObject::connect(&clientProcess, &QProcess::errorOccurred, &a, [](auto error) {
-        if (error == QProcess::FailedToStart) {
-            qFatal("Couldn't start client executable");
-        }
-    });
+    auto settings = Trainer::Settings{};
+    settings.config = config;
+    settings.client = client.absoluteFilePath();
+    settings.jobs = parser.value(jobsOption).toInt();
+    if (settings.jobs <= 0)
+        settings.jobs = max(QThread::idealThreadCount(), 1);
+    settings.episodeTimeout = max(parser.value(timeoutOption).toInt(), 0);
+    settings.summaryPath = parser.value(summaryOption);
+    settings.summaryInterval = max(parser.value(summaryIntervalOption).toInt(), 1);
+    settings.archiveDirectory = parser.value(archivesOption);
+    settings.archiveLimit = max(parser.value(archiveLimitOption).toLongLong(), 0LL) << 20;
 
-    QObject::connect(&serverProcess, &QProcess::finished, &a, tryStartSimulation);
+    auto plan = unique_ptr<EpisodePlan>{};
+    if (parser.isSet(tuneOption))
+        plan = Tuner::load(parser.value(tuneOption),
+                           parser.value(tuneReportOption),
+                           settings.client);
+    else
+        plan = make_unique<RepeatPlan>(max(parser.value(episodesOption).toInt(), 0));
 
-    tryStartSimulation();
-    clientProcess.start("./bootstrap_client.sh", {"31001"});
+    Trainer trainer{settings, std::move(plan)};
+    QObject::connect(&trainer, &Trainer::done, &a, &QCoreApplication::quit, Qt::QueuedConnection);
+    trainer.start();
     return a.exec();
 }
@@ -1,196 +1,147 @@
 #include "MyStrategy.hpp"
 
-#include <exception>
-#include <iostream>
-#include <memory>
-
-#include <behaviortree_cpp_v3/basic_types.h>
-
-#include "behavior_nodes/LookAction.h"
-#include "behavior_nodes/GoToTarget.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
 
 using namespace std;
-using namespace BT;
 using namespace model;
 
 constexpr auto DEBUG = false;
 constexpr auto BEHAVIOR_FILE = "main_behavior.xml";
-
-namespace BT {
-
-template<>
-inline Vec2 convertFromString(StringView str)
+constexpr auto RECORD = false; // writes constants and every game to RECORD_FILE for benchmarks
+constexpr auto RECORD_FILE = "games.bin";
+
+MyStrategy::MyStrategy(Constants constants,
+                       StrategyParameters parameters,
+                       string behaviorsPath,
+                       bool hotReload)
+    : m_derived{move(constants)}, m_parameters{parameters}, m_constants{m_derived.constants()},
+      m_behaviorsPath{move(behaviorsPath)}, m_game{&m_arena}, m_dangerMap{m_derived},
+      m_zonePredictor{m_derived}, m_obstacleIndex{m_constants},
+      m_threadPool{static_cast<size_t>(
+          max(min(m_constants.teamSize, static_cast<int>(thread::hardware_concurrency())), 1) - 1)},
+      m_order{{}}
 {
-    auto parts = splitString(str, ',');
-    if (parts.size() != 2) {
-        throw RuntimeError("invalid input in behavior tree");
-    } else {
-        Vec2 vector;
-        vector.x = convertFromString<float>(parts[0]);
-        vector.y = convertFromString<float>(parts[1]);
-        return vector;
-    }
-}
+    if (m_constants.weapons.size() > Unit::MAX_WEAPONS)
+        throw runtime_error("units can't hold ammo of that many weapons");
 
-} // namespace BT
+    if (RECORD) {
+        m_recording = make_unique<FileStream>(RECORD_FILE, ios::out | ios::trunc);
+        m_constants.writeTo(*m_recording);
+    }
 
+    // one watcher for the controllers of all units, they share the file
+    if (hotReload)
+        m_reloader = make_unique<TreeReloader>(m_behaviorsPath, BEHAVIOR_FILE);
+}
 
-MyStrategy::MyStrategy(const Constants &constants)
-    : m_blackboard{Blackboard::create()}, m_constants{constants}
+Game &MyStrategy::nextGame()
 {
-    registerNodes();
-    initTree();
+    // the previous game is destroyed before the arena reuses its memory
+    m_game = Game{&m_arena};
+    m_arena.reset();
+    return m_game;
 }
 
-Order MyStrategy::getOrder(Game &&game, DebugInterface *debugInterface)
+const Order &MyStrategy::getOrder(DebugInterface *debugInterface)
 {
-    m_enemies.clear();
-    m_order = {};
+    m_units.clear();
 
-    // state initialization
-    m_game = move(game);
+    if (m_recording)
+        m_game.writeTo(*m_recording);
+
+    // state initialization, the containers are updated in place to keep ticks free of allocations
     for (auto &unit : m_game.units) {
         if (unit.playerId == m_game.myId) {
-            m_unit = unit;
+            m_units.emplace_back(&controller(unit.id), &unit);
         } else {
-            m_enemies.emplace(unit.id, ref(unit));
+            seeEnemy(unit);
         }
     }
+    // enemies that aren't visible anymore refer to the previous game, whose memory the arena may
+    // have given to this one, so they are told apart by the tick only
+    for (auto it = begin(m_enemies); it != end(m_enemies);) {
+        const auto current = it++;
+        if (current->second.lastSeenTick != m_game.currentTick)
+            m_spareEnemies.push_back(m_enemies.extract(current));
+    }
+    m_dangerMap.update(m_game);
+    m_zonePredictor.update(m_game.zone, m_game.currentTick);
+
+    // ticking, every unit only writes its own slot
+    m_results.resize(m_units.size());
+    m_threadPool.run(m_units.size(), [this](size_t i) {
+        const auto [controller, unit] = m_units[i];
+        m_results[i] = controller->tick(*unit);
+    });
 
-    // ticking
-    if (m_tree.tickRoot() == NodeStatus::FAILURE) {
-        return Order{unordered_map<int, UnitOrder>()};
-    } else {
-        m_orders[m_unit.id] = m_order;
-        return Order{m_orders};
+    auto &orders = m_order.unitOrders;
+    erase_if(orders, [this](const auto &entry) {
+        return none_of(cbegin(m_units), cend(m_units), [&entry](const auto &unit) {
+            return unit.second->id == entry.first;
+        });
+    });
+    for (size_t i = 0; i < m_units.size(); ++i) {
+        if (m_results[i])
+            orders[m_units[i].second->id] = move(m_results[i].value());
+        else
+            orders.erase(m_units[i].second->id);
     }
+    return m_order;
 }
 
-void MyStrategy::debugUpdate(int displayedTick, DebugInterface &debugInterface) {}
-
-void MyStrategy::finish() {}
-
-void MyStrategy::registerNodes()
+void MyStrategy::debugUpdate(int displayedTick, DebugInterface &debugInterface)
 {
-    const auto lookBuilder = [this](const string &name, const NodeConfiguration &config) {
-        return make_unique<LookAction>(m_enemies, m_unit, m_order, name, config);
-    };
-
-    const auto goToTargetBuilder = [this](const string &name, const NodeConfiguration &config) {
-        return make_unique<GoToTarget>(m_constants, m_enemies, m_unit, m_order, name, config);
-    };
-
-    // --- ports list
-
-    PortsList vectorPort = {InputPort<Vec2>("vector")};
-    PortsList idOutPort = {OutputPort<int>("id")};
-    PortsList idInPort = {InputPort<int>("id")};
-
-
-    // ---- action nodes
-
-    m_factory.registerBuilder<LookAction>("Look", lookBuilder);
-    m_factory.registerBuilder<GoToTarget>("GoToTarget", goToTargetBuilder);
-
-    m_factory.registerSimpleAction(
-        "Move",
-        [this](TreeNode &self) {
-            auto vector = self.getInput<Vec2>("vector");
-            if (!vector) {
-                cout << "Couldn't find port: vector" << endl;
-                return NodeStatus::FAILURE;
-            }
-
-            m_order.targetVelocity = normalizeVelocity(vector.value(),
-                                                       m_constants.maxUnitForwardSpeed);
-            return NodeStatus::SUCCESS;
-        },
-        vectorPort);
-
-    m_factory.registerSimpleAction("Dodge", [this](TreeNode &) {
-        Vec2 result;
-        bool hasIntersect = false;
-        for (const Projectile &projectile : m_game.projectiles) {
-            if (projectile.shooterPlayerId == m_game.myId)
-                continue;
-
-            const auto [intersect, normal] = rayCircleIntersectNormalVector(projectile.position,
-                                                                            projectile.velocity,
-                                                                            m_unit.position,
-                                                                            m_constants.unitRadius);
-            if (intersect) {
-                result += normal;
-                hasIntersect = true;
-            }
-        }
-
-        if (hasIntersect) {
-            m_order.targetVelocity = normalizeVelocity(result, m_constants.maxUnitForwardSpeed);
-        }
-        return hasIntersect ? NodeStatus::SUCCESS : NodeStatus::FAILURE;
-    });
-
-    m_factory.registerSimpleAction("AvoidZone", [this](TreeNode &) {
-        constexpr auto PADDING = 0.5; // units
-        const auto unitToZoneVec = m_game.zone.currentCenter - m_unit.position;
-        if (m_game.zone.currentRadius - unitToZoneVec.length() < m_constants.unitRadius + PADDING) {
-            m_order.targetVelocity = normalizeVelocity(unitToZoneVec, m_constants.maxUnitForwardSpeed);
-            return NodeStatus::SUCCESS;
-        } else {
-            return NodeStatus::FAILURE;
-        }
-    });
+    if (DEBUG) {
+        debugInterface.clear();
+        m_dangerMap.draw(debugInterface);
+    }
+}
 
-    m_factory.registerSimpleAction(
-        "GetClosestTarget",
-        [this](TreeNode &self) {
-            const auto it = min_element(
-                cbegin(m_enemies), cend(m_enemies), [this](const auto &left, const auto &right) {
-                    return (m_unit.position - left.second.get().position).sqrLength()
-                           < (m_unit.position - right.second.get().position).sqrLength();
-                });
-
-            if (it == cend(m_enemies)) {
-                return NodeStatus::FAILURE;
-            } else {
-                self.setOutput("id", it->first);
-                return NodeStatus::SUCCESS;
-            }
-        },
-        idOutPort);
-
-    m_factory.registerSimpleAction(
-        "Shoot",
-        [this](TreeNode &self) {
-            if (!m_unit.weapon || m_unit.ammo.at(m_unit.weapon.value()) == 0)
-                return NodeStatus::FAILURE;
-
-            m_order.action = make_shared<ActionOrder::Aim>(true);
-            return NodeStatus::SUCCESS;
-        },
-        idInPort);
-
-    m_factory.registerSimpleAction("GoCenter", [this](TreeNode &self) {
-        const auto direction = m_game.zone.currentCenter - m_unit.position;
-        m_order.targetVelocity = normalizeVelocity(direction, m_constants.maxUnitForwardSpeed);
-        m_order.targetDirection = direction;
-        return NodeStatus::SUCCESS;
-    });
+void MyStrategy::finish()
+{
+    if (m_recording)
+        m_recording->flush();
 
-    // ---- condition nodes
+    for (auto &[id, controller] : m_controllers)
+        controller->finish();
+}
 
-    // ---- decorator nodes
+void MyStrategy::seeEnemy(Unit &unit)
+{
+    const auto seen = SeenEnemy{ref(unit), m_game.currentTick};
+    if (const auto it = m_enemies.find(unit.id); it != end(m_enemies)) {
+        it->second = seen;
+    } else if (m_spareEnemies.empty()) {
+        m_enemies.emplace(unit.id, seen);
+    } else {
+        auto node = move(m_spareEnemies.back());
+        m_spareEnemies.pop_back();
+        node.key() = unit.id;
+        node.mapped() = seen;
+        m_enemies.insert(move(node));
+    }
 }
 
-void MyStrategy::initTree()
+UnitController &MyStrategy::controller(int unitId)
 {
-    try {
-        m_tree = m_factory.createTreeFromFile(string{BEHAVIORS_PATH} + BEHAVIOR_FILE,
-                                              m_blackboard);
-        if (DEBUG) {
-            m_logger = make_unique<StdCoutLogger>(m_tree);
-        }
-    } catch (const runtime_error &e) {
-        cout << e.what() << endl;
+    auto it = m_controllers.find(unitId);
+    if (it == end(m_controllers)) {
+        // BT::StdCoutLogger allows a single instance
+        const auto logTransitions = DEBUG && m_controllers.empty();
+        auto controller = make_unique<UnitController>(m_derived,
+                                                      m_parameters,
+                                                      m_game,
+                                                      m_enemies,
+                                                      m_zonePredictor,
+                                                      m_obstacleIndex,
+                                                      m_dangerMap,
+                                                      m_behaviorsPath,
+                                                      BEHAVIOR_FILE,
+                                                      logTransitions,
+                                                      m_reloader.get());
+        it = m_controllers.emplace(unitId, move(controller)).first;
     }
+    return *it->second;
 }
@@ -4,37 +4,74 @@
 #include "model/Constants.hpp"
 #include "model/Game.hpp"
 #include "model/Order.hpp"
+#include "tree/UnitController.h"
+#include "utils/FileStream.h"
+#include "utils/ThreadPool.h"
+#include "utils/TickArena.h"
+#include "world/DangerMap.h"
+#include "world/DerivedConstants.h"
+#include "world/ObstacleIndex.h"
+#include "world/ZonePredictor.h"
 
-#include <behaviortree_cpp_v3/bt_factory.h>
-#include <behaviortree_cpp_v3/loggers/bt_cout_logger.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 class MyStrategy
 {
-    template<typename T>
-    using Ref = std::reference_wrapper<T>;
-
 public:
-    MyStrategy(const model::Constants &constants);
-    model::Order getOrder(model::Game &&game, DebugInterface *debugInterface);
+    /**
+     * @param hotReload Whether to rebuild the behavior trees when their file changes.
+     */
+    MyStrategy(model::Constants constants,
+               StrategyParameters parameters = {},
+               std::string behaviorsPath = BEHAVIORS_PATH,
+               bool hotReload = false);
+    /**
+     * Releases the game of the previous tick with everything else allocated for it.
+     *
+     * @return Empty game to decode the next tick into, its lists allocate from the tick arena.
+     */
+    model::Game &nextGame();
+    /**
+     * @return Orders of all own units for the game returned by `nextGame`, valid until the next
+     * call.
+     */
+    const model::Order &getOrder(DebugInterface *debugInterface);
     void debugUpdate(int displayedTick, DebugInterface &debugInterface);
     void finish();
 
 private:
-    void registerNodes();
-    void initTree();
+    /**
+     * Adds or refreshes @p unit in the visible enemies, in the node of an enemy gone out of view
+     * if there is one.
+     */
+    void seeEnemy(model::Unit &unit);
+    UnitController &controller(int unitId);
 
 private:
-    BT::Blackboard::Ptr m_blackboard;
-    BT::BehaviorTreeFactory m_factory;
-    BT::Tree m_tree;
-    std::unique_ptr<BT::StdCoutLogger> m_logger;
-
-    model::Constants m_constants;
+    const DerivedConstants m_derived;
+    const StrategyParameters m_parameters;
+    const model::Constants &m_constants;
+    std::string m_behaviorsPath;
+    TickArena m_arena;
     model::Game m_game;
-    model::Unit m_dummyUnit;
-    model::Unit &m_unit = m_dummyUnit;
-    std::unordered_map<int, Ref<model::Unit>> m_enemies;
+    EnemyMap m_enemies;
+    // nodes of enemies gone out of view, reused for the next ones so that a tick doesn't allocate
+    std::vector<EnemyMap::node_type> m_spareEnemies;
+    DangerMap m_dangerMap;
+    ZonePredictor m_zonePredictor;
+    ObstacleIndex m_obstacleIndex;
+    std::unique_ptr<FileStream> m_recording;
 
-    model::UnitOrder m_order;
-    std::unordered_map<int, model::UnitOrder> m_orders;
+    ThreadPool m_threadPool;
+    // own units alive this tick and their orders
+    std::vector<std::pair<UnitController *, const model::Unit *>> m_units;
+    std::vector<std::optional<model::UnitOrder>> m_results;
+    model::Order m_order;
+    std::unique_ptr<TreeReloader> m_reloader;
+    // refer to the world state and the reloader above, must be destroyed first
+    std::unordered_map<int, std::unique_ptr<UnitController>> m_controllers;
 };
@@ -1,6 +1,48 @@
 #include "TcpStream.hpp"
+#include <cerrno>
+#include <chrono>
 #include <cstring>
 #include <stdexcept>
+#include <thread>
+
+namespace {
+
+// a trainer starts the client before the server of its next game listens, so a refused
+// connection is retried, like the python client does
+const auto CONNECT_RETRY_INTERVAL = std::chrono::milliseconds(100);
+
+SOCKET createSocket()
+{
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock == -1) {
+        throw std::runtime_error("Failed to create socket");
+    }
+    int yes = 1;
+    if (setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char*)&yes, sizeof(int)) < 0) {
+        throw std::runtime_error("Failed to set TCP_NODELAY");
+    }
+    return sock;
+}
+
+bool connectionRefused()
+{
+#ifdef _WIN32
+    return WSAGetLastError() == WSAECONNREFUSED;
+#else
+    return errno == ECONNREFUSED;
+#endif
+}
+
+void closeSocket(SOCKET sock)
+{
+#ifdef _WIN32
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+}
+
+} // namespace
 
 TcpStream::TcpStream(const std::string& host, int port)
     : readBufferPos(0)
@@ -14,14 +56,6 @@ TcpStream::TcpStream(const std::string& host, int port)
         throw std::runtime_error("Failed to initialize sockets");
     }
 #endif
-    sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (sock == -1) {
-        throw std::runtime_error("Failed to create socket");
-    }
-    int yes = 1;
-    if (setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char*)&yes, sizeof(int)) < 0) {
-        throw std::runtime_error("Failed to set TCP_NODELAY");
-    }
     addrinfo hints, *servinfo;
     std::memset(&hints, 0, sizeof(hints));
     hints.ai_family = AF_INET;
@@ -31,12 +65,35 @@ TcpStream::TcpStream(const std::string& host, int port)
         != 0) {
         throw std::runtime_error("Failed to get addr info");
     }
-    if (connect(sock, servinfo->ai_addr, servinfo->ai_addrlen) == -1) {
-        throw std::runtime_error("Failed to connect");
+    while (true) {
+        sock = createSocket();
+        if (connect(sock, servinfo->ai_addr, servinfo->ai_addrlen) != -1) {
+            break;
+        }
+        const bool refused = connectionRefused();
+        closeSocket(sock);
+        if (!refused) {
+            freeaddrinfo(servinfo);
+            throw std::runtime_error("Failed to connect");
+        }
+        std::this_thread::sleep_for(CONNECT_RETRY_INTERVAL);
     }
     freeaddrinfo(servinfo);
 }
 
+TcpStream::TcpStream(SOCKET sock)
+    : sock(sock)
+    , readBufferPos(0)
+    , readBufferSize(0)
+    , writeBufferPos(0)
+    , writeBufferSize(0)
+{
+    int yes = 1;
+    if (setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char*)&yes, sizeof(int)) < 0) {
+        throw std::runtime_error("Failed to set TCP_NODELAY");
+    }
+}
+
 void TcpStream::readBytes(char* buffer, size_t byteCount)
 {
     while (byteCount > 0) {
@@ -61,6 +118,9 @@ void TcpStream::readBytes(char* buffer, size_t byteCount)
         if (received < 0) {
             throw std::runtime_error("Failed to read from socket");
         }
+        if (received == 0) {
+            throw std::runtime_error("Connection closed");
+        }
         readBufferSize += received;
     }
 }
@@ -0,0 +1,184 @@
+#include "Actions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numbers>
+
+using namespace std;
+using namespace BT;
+using namespace model;
+
+constexpr auto APPROACH_TURN = numbers::pi / 6;
+constexpr auto APPROACH_LOOKAHEAD = 1.0; // seconds
+
+Actions::Actions(const DerivedConstants &constants,
+                 const StrategyParameters &parameters,
+                 const Game &game,
+                 const Unit &unit,
+                 const EnemyMap &enemies,
+                 UnitOrder &order,
+                 WorldFacts &facts,
+                 const ZonePredictor &zonePredictor,
+                 const ObstacleIndex &obstacleIndex,
+                 const DangerMap &dangerMap)
+    : m_constants{constants.constants()},
+      m_parameters{parameters},
+      m_game{game},
+      m_unit{unit},
+      m_enemies{enemies},
+      m_order{order},
+      m_facts{facts},
+      m_zonePredictor{zonePredictor},
+      m_dangerMap{dangerMap},
+      m_targetScorer{constants, obstacleIndex},
+      m_aim{make_shared<ActionOrder::Aim>(true)}
+{}
+
+NodeStatus Actions::move(const optional<Vec2> &vector)
+{
+    if (!vector) {
+        cout << "Couldn't find port: vector" << endl;
+        return NodeStatus::FAILURE;
+    }
+
+    m_order.targetVelocity = normalizeVelocity(vector.value(), m_constants.maxUnitForwardSpeed);
+    return NodeStatus::SUCCESS;
+}
+
+NodeStatus Actions::dodge()
+{
+    Vec2 result;
+    bool hasIntersect = false;
+    for (const Projectile &projectile : m_game.projectiles) {
+        if (projectile.shooterPlayerId == m_game.myId)
+            continue;
+
+        const auto [intersect, normal] = rayCircleIntersectNormalVector(projectile.position,
+                                                                        projectile.velocity,
+                                                                        m_unit.position,
+                                                                        m_constants.unitRadius);
+        if (intersect) {
+            result += normal;
+            hasIntersect = true;
+        }
+    }
+
+    if (hasIntersect) {
+        m_order.targetVelocity = normalizeVelocity(result, m_constants.maxUnitForwardSpeed);
+    }
+    return hasIntersect ? NodeStatus::SUCCESS : NodeStatus::FAILURE;
+}
+
+NodeStatus Actions::avoidZone()
+{
+    const auto departureTick = m_zonePredictor.latestDepartureTick(m_unit.position,
+                                                                   m_constants.maxUnitForwardSpeed,
+                                                                   m_constants.unitRadius
+                                                                       + m_parameters.zonePadding);
+    if (departureTick <= m_game.currentTick) {
+        const auto unitToZoneVec = m_game.zone.nextCenter - m_unit.position;
+        m_order.targetVelocity = normalizeVelocity(unitToZoneVec, m_constants.maxUnitForwardSpeed);
+        return NodeStatus::SUCCESS;
+    } else {
+        return NodeStatus::FAILURE;
+    }
+}
+
+NodeStatus Actions::shoot()
+{
+    if (!m_unit.weapon || m_unit.ammo.at(m_unit.weapon.value()) == 0)
+        return NodeStatus::FAILURE;
+
+    m_order.action = m_aim;
+    return NodeStatus::SUCCESS;
+}
+
+NodeStatus Actions::goCenter()
+{
+    const auto &direction = m_facts.toZoneCenter();
+    m_order.targetVelocity = normalizeVelocity(direction, m_constants.maxUnitForwardSpeed);
+    m_order.targetDirection = direction;
+    return NodeStatus::SUCCESS;
+}
+
+NodeStatus Actions::look(const optional<Vec2> &vector, const optional<int> &id)
+{
+    if (!vector && !id) {
+        cout << "Couldn't find port: vector or id" << endl;
+        return NodeStatus::FAILURE;
+    }
+
+    m_order.targetDirection = id ? m_facts.toEnemy(id.value()) : vector.value();
+    const auto direction = id ? m_facts.enemyDirection(id.value()) : vector.value().normalize();
+    if (dotProduct(direction, m_unit.direction) > m_parameters.cosThreshold) {
+        return NodeStatus::SUCCESS;
+    } else {
+        return NodeStatus::RUNNING;
+    }
+}
+
+NodeStatus Actions::goToTarget(const optional<int> &id)
+{
+    const auto weaponRange = m_facts.weaponRange();
+    if (!weaponRange)
+        return NodeStatus::FAILURE;
+
+    if (!id) {
+        cout << "Couldn't find port: id" << endl;
+        return NodeStatus::FAILURE;
+    }
+
+    const auto shootRange = weaponRange.value() * m_parameters.shootRangeRatio;
+    if (m_facts.enemyDistance(id.value()) <= shootRange) {
+        return NodeStatus::SUCCESS;
+    } else {
+        m_order.targetVelocity = safestHeading(m_facts.enemyDirection(id.value()))
+                                 * m_constants.maxUnitForwardSpeed;
+        return NodeStatus::RUNNING;
+    }
+}
+
+optional<int> Actions::closestTarget()
+{
+    const auto it = min_element(cbegin(m_enemies),
+                                cend(m_enemies),
+                                [this](const auto &left, const auto &right) {
+                                    return m_facts.enemyDistance(left.first)
+                                           < m_facts.enemyDistance(right.first);
+                                });
+
+    if (it == cend(m_enemies))
+        return nullopt;
+    return it->first;
+}
+
+const vector<int> &Actions::rankedTargets()
+{
+    return m_targetScorer.rank(m_game, m_unit);
+}
+
+Vec2 Actions::safestHeading(const Vec2 &direction) const
+{
+    const auto lookahead = m_constants.maxUnitForwardSpeed * APPROACH_LOOKAHEAD;
+    const auto danger = [&](const Vec2 &heading) {
+        return m_dangerMap.pathDanger(m_unit.position,
+                                      m_unit.position + heading * lookahead,
+                                      m_constants.unitRadius);
+    };
+
+    auto best = direction;
+    auto bestDanger = danger(direction);
+    const auto cosTurn = cos(APPROACH_TURN);
+    const auto sinTurn = sin(APPROACH_TURN);
+    for (const auto sign : {-1.0, 1.0}) {
+        const auto heading = Vec2{direction.x * cosTurn - sign * direction.y * sinTurn,
+                                  sign * direction.x * sinTurn + direction.y * cosTurn};
+        const auto headingDanger = danger(heading);
+        if (headingDanger < bestDanger) {
+            best = heading;
+            bestDanger = headingDanger;
+        }
+    }
+    return best;
+}
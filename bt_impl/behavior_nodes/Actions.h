@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <behaviortree_cpp_v3/basic_types.h>
+
+#include "model/ActionOrder.hpp"
+#include "model/Game.hpp"
+#include "model/UnitOrder.hpp"
+#include "world/DangerMap.h"
+#include "world/DerivedConstants.h"
+#include "world/StrategyParameters.h"
+#include "world/TargetScorer.h"
+#include "world/WorldFacts.h"
+#include "world/ZonePredictor.h"
+
+/**
+ * Behavior of every leaf node, independent of how the tree is executed.
+ *
+ * The behavior tree nodes registered in MyStrategy and the trees compiled from XML at build time
+ * both call into this class, so their decisions can't diverge. Missing input ports are passed as
+ * empty optionals, output ports are returned.
+ */
+class Actions
+{
+public:
+    Actions(const DerivedConstants &constants,
+            const StrategyParameters &parameters,
+            const model::Game &game,
+            const model::Unit &unit,
+            const EnemyMap &enemies,
+            model::UnitOrder &order,
+            WorldFacts &facts,
+            const ZonePredictor &zonePredictor,
+            const ObstacleIndex &obstacleIndex,
+            const DangerMap &dangerMap);
+
+    BT::NodeStatus move(const std::optional<model::Vec2> &vector);
+    BT::NodeStatus dodge();
+    BT::NodeStatus avoidZone();
+    BT::NodeStatus shoot();
+    BT::NodeStatus goCenter();
+    BT::NodeStatus look(const std::optional<model::Vec2> &vector, const std::optional<int> &id);
+    /**
+     * Approaches the enemy straight or turned aside, whichever crosses the least danger.
+     *
+     * @note Must have a weapon in hand.
+     */
+    BT::NodeStatus goToTarget(const std::optional<int> &id);
+
+    /**
+     * @return Id of the closest enemy, or nothing if there are no enemies.
+     */
+    std::optional<int> closestTarget();
+    /**
+     * @return Enemy ids from the best target to the worst.
+     */
+    const std::vector<int> &rankedTargets();
+
+private:
+    /**
+     * @return @p direction or @p direction turned by APPROACH_TURN either way, whichever path of
+     * the next APPROACH_LOOKAHEAD seconds has the least danger, @p direction on ties.
+     */
+    model::Vec2 safestHeading(const model::Vec2 &direction) const;
+
+private:
+    const model::Constants &m_constants;
+    const StrategyParameters &m_parameters;
+    const model::Game &m_game;
+    const model::Unit &m_unit;
+    const EnemyMap &m_enemies;
+    model::UnitOrder &m_order;
+    WorldFacts &m_facts;
+    const ZonePredictor &m_zonePredictor;
+    const DangerMap &m_dangerMap;
+    TargetScorer m_targetScorer;
+    // orders only hold on to actions, so one instance serves every tick
+    const std::shared_ptr<model::ActionOrder> m_aim;
+};
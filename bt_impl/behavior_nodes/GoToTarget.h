@@ -9,9 +9,8 @@
 
 #include <behaviortree_cpp_v3/action_node.h>
 
-#include "model/Game.hpp"
-#include "model/UnitOrder.hpp"
-#include "model/Constants.hpp"
+#include "behavior_nodes/Actions.h"
+#include "behavior_nodes/PortSlots.h"
 
 /**
  * @note Must have a weapon in hand.
@@ -19,12 +18,7 @@
 class GoToTarget : public BT::StatefulActionNode
 {
 public:
-    GoToTarget(const model::Constants &constants,
-               const EnemyMap &enemies,
-               const model::Unit &unit,
-               model::UnitOrder &order,
-               const std::string &name,
-               const BT::NodeConfiguration &config);
+    GoToTarget(Actions &actions, const std::string &name, const BT::NodeConfiguration &config);
 
     static BT::PortsList providedPorts();
 
@@ -33,8 +27,6 @@ public:
     virtual void onHalted() override;
 
 private:
-    const model::Constants &m_constants;
-    const EnemyMap &m_enemies;
-    const model::Unit &m_unit;
-    model::UnitOrder &m_order;
+    Actions &m_actions;
+    InputSlot<int> m_id;
 };
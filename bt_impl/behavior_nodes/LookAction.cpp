@@ -13,14 +13,9 @@ using namespace std;
 using namespace BT;
 using namespace model;
 
-constexpr auto COS_THRESHOLD = 0.99;
-
-LookAction::LookAction(const EnemyMap &enemies,
-                       const Unit &unit,
-                       UnitOrder &order,
-                       const string &name,
-                       const NodeConfiguration &config)
-    : StatefulActionNode{name, config}, m_enemies{enemies}, m_unit{unit}, m_order{order}
+LookAction::LookAction(Actions &actions, const string &name, const NodeConfiguration &config)
+    : StatefulActionNode{name, config}, m_actions{actions}, m_vector{config, "vector"},
+      m_id{config, "id"}
 {}
 
 PortsList LookAction::providedPorts()
@@ -30,20 +25,7 @@ PortsList LookAction::providedPorts()
 
 NodeStatus LookAction::onStart()
 {
-    auto vector = getInput<Vec2>("vector");
-    auto id = getInput<int>("id");
-    if (!vector && !id) {
-        cout << "Couldn't find port: vector or id" << endl;
-        return NodeStatus::FAILURE;
-    }
-
-    m_order.targetDirection = id ? m_enemies.at(id.value()).get().position - m_unit.position
-                                 : vector.value();
-    if (dotProduct(m_order.targetDirection.normalize(), m_unit.direction) > COS_THRESHOLD) {
-        return NodeStatus::SUCCESS;
-    } else {
-        return NodeStatus::RUNNING;
-    }
+    return m_actions.look(m_vector.get(), m_id.get());
 }
 
 NodeStatus LookAction::onRunning()
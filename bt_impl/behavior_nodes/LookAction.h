@@ -9,17 +9,13 @@
 
 #include <behaviortree_cpp_v3/action_node.h>
 
-#include "model/Game.hpp"
-#include "model/UnitOrder.hpp"
+#include "behavior_nodes/Actions.h"
+#include "behavior_nodes/PortSlots.h"
 
 class LookAction : public BT::StatefulActionNode
 {
 public:
-    LookAction(const EnemyMap &enemies,
-               const model::Unit &unit,
-               model::UnitOrder &order,
-               const std::string &name,
-               const BT::NodeConfiguration &config);
+    LookAction(Actions &actions, const std::string &name, const BT::NodeConfiguration &config);
 
     static BT::PortsList providedPorts();
 
@@ -28,7 +24,7 @@ public:
     virtual void onHalted() override;
 
 private:
-    const EnemyMap &m_enemies;
-    const model::Unit &m_unit;
-    model::UnitOrder &m_order;
+    Actions &m_actions;
+    InputSlot<model::Vec2> m_vector;
+    InputSlot<int> m_id;
 };
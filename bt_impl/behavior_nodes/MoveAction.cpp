@@ -0,0 +1,19 @@
+#include "MoveAction.h"
+
+using namespace std;
+using namespace BT;
+using namespace model;
+
+MoveAction::MoveAction(Actions &actions, const string &name, const NodeConfiguration &config)
+    : SyncActionNode{name, config}, m_actions{actions}, m_vector{config, "vector"}
+{}
+
+PortsList MoveAction::providedPorts()
+{
+    return {InputPort<Vec2>("vector")};
+}
+
+NodeStatus MoveAction::tick()
+{
+    return m_actions.move(m_vector.get());
+}
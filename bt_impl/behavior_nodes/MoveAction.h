@@ -0,0 +1,20 @@
+#pragma once
+
+#include <behaviortree_cpp_v3/action_node.h>
+
+#include "behavior_nodes/Actions.h"
+#include "behavior_nodes/PortSlots.h"
+
+class MoveAction : public BT::SyncActionNode
+{
+public:
+    MoveAction(Actions &actions, const std::string &name, const BT::NodeConfiguration &config);
+
+    static BT::PortsList providedPorts();
+
+    virtual BT::NodeStatus tick() override;
+
+private:
+    Actions &m_actions;
+    InputSlot<model::Vec2> m_vector;
+};
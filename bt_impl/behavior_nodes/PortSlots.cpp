@@ -0,0 +1,38 @@
+#include "PortSlots.h"
+
+using namespace std;
+using namespace BT;
+
+PortSlot::PortSlot(const NodeConfiguration &config, const string &port, bool output)
+    : m_blackboard{config.blackboard}
+{
+    const auto &ports = output ? config.output_ports : config.input_ports;
+    const auto it = ports.find(port);
+    if (it == cend(ports))
+        return;
+
+    if (const auto key = TreeNode::getRemappedKey(port, it->second)) {
+        m_key = string{key.value()};
+    } else {
+        m_literal = it->second;
+    }
+}
+
+void PortSlot::checkType(const type_info &type)
+{
+    if (m_key.empty() || !m_blackboard)
+        return;
+
+    const auto *info = m_blackboard->portInfo(m_key);
+    if (info && info->type() && *info->type() != type) {
+        throw RuntimeError("Blackboard entry \"" + m_key + "\" has type "
+                           + demangle(*info->type()) + ", the port uses " + demangle(type));
+    }
+}
+
+Any *PortSlot::entry()
+{
+    if (!m_entry && !m_key.empty() && m_blackboard)
+        m_entry = m_blackboard->getAny(m_key);
+    return m_entry;
+}
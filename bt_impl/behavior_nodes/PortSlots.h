@@ -0,0 +1,121 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <typeinfo>
+
+#include <behaviortree_cpp_v3/basic_types.h>
+#include <behaviortree_cpp_v3/blackboard.h>
+#include <behaviortree_cpp_v3/tree_node.h>
+
+#include "model/Vec2.hpp"
+
+namespace BT {
+
+template<>
+inline model::Vec2 convertFromString(StringView str)
+{
+    auto parts = splitString(str, ',');
+    if (parts.size() != 2) {
+        throw RuntimeError("invalid input in behavior tree");
+    } else {
+        model::Vec2 vector;
+        vector.x = convertFromString<float>(parts[0]);
+        vector.y = convertFromString<float>(parts[1]);
+        return vector;
+    }
+}
+
+} // namespace BT
+
+/**
+ * Port resolved once, when its node is created.
+ *
+ * A blackboard pointer like "{target_id}" is resolved to the blackboard entry, so reading or
+ * writing the port doesn't look up any strings. Entries are normally created together with the
+ * tree, one that doesn't exist yet is looked up again on the next access, and writing it creates
+ * it through the blackboard.
+ *
+ * Writes to an existing entry skip the blackboard's mutex and its type check, the tree is only
+ * ticked from one thread and the type of the entry is checked once, when the slot is created.
+ */
+class PortSlot
+{
+public:
+    PortSlot(const BT::NodeConfiguration &config, const std::string &port, bool output);
+
+protected:
+    /**
+     * @throw BT::RuntimeError if the entry was declared with a type other than @p type, so the
+     * mismatch fails the creation of the tree instead of a later cast.
+     */
+    void checkType(const std::type_info &type);
+    BT::Any *entry();
+
+    template<typename T>
+    void createEntry(const T &value)
+    {
+        if (!m_key.empty() && m_blackboard)
+            m_blackboard->set(m_key, value);
+    }
+
+protected:
+    std::optional<std::string> m_literal;
+
+private:
+    BT::Blackboard::Ptr m_blackboard;
+    std::string m_key;
+    BT::Any *m_entry = nullptr;
+};
+
+/**
+ * Input port whose literal value is parsed once instead of on every `getInput`.
+ */
+template<typename T>
+class InputSlot : public PortSlot
+{
+public:
+    InputSlot(const BT::NodeConfiguration &config, const std::string &port)
+        : PortSlot{config, port, false}
+    {
+        checkType(typeid(T));
+        if (m_literal)
+            m_constant = BT::convertFromString<T>(m_literal.value());
+    }
+
+    /**
+     * @return Value of the port, or nothing if it isn't set.
+     */
+    std::optional<T> get()
+    {
+        if (m_constant)
+            return m_constant;
+
+        const auto *value = entry();
+        if (!value || value->empty())
+            return std::nullopt;
+        return value->template cast<T>();
+    }
+
+private:
+    std::optional<T> m_constant;
+};
+
+template<typename T>
+class OutputSlot : public PortSlot
+{
+public:
+    OutputSlot(const BT::NodeConfiguration &config, const std::string &port)
+        : PortSlot{config, port, true}
+    {
+        checkType(typeid(T));
+    }
+
+    void set(const T &value)
+    {
+        if (auto *target = entry())
+            *target = BT::Any{value};
+        else
+            createEntry(value);
+    }
+};
@@ -0,0 +1,23 @@
+#include "RankTargets.h"
+
+using namespace std;
+using namespace BT;
+
+RankTargets::RankTargets(Actions &actions, const string &name, const NodeConfiguration &config)
+    : SyncActionNode{name, config}, m_actions{actions}, m_id{config, "id"}
+{}
+
+PortsList RankTargets::providedPorts()
+{
+    return {OutputPort<int>("id")};
+}
+
+NodeStatus RankTargets::tick()
+{
+    const auto &ranked = m_actions.rankedTargets();
+    if (ranked.empty())
+        return NodeStatus::FAILURE;
+
+    m_id.set(ranked.front());
+    return NodeStatus::SUCCESS;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <behaviortree_cpp_v3/action_node.h>
+
+#include "behavior_nodes/Actions.h"
+#include "behavior_nodes/PortSlots.h"
+
+/**
+ * Ranks visible enemies with TargetScorer. Outputs the best target to `id`, fails if there are
+ * no enemies.
+ */
+class RankTargets : public BT::SyncActionNode
+{
+public:
+    RankTargets(Actions &actions, const std::string &name, const BT::NodeConfiguration &config);
+
+    static BT::PortsList providedPorts();
+
+    virtual BT::NodeStatus tick() override;
+
+private:
+    Actions &m_actions;
+    OutputSlot<int> m_id;
+};
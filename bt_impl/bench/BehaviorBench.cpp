@@ -0,0 +1,412 @@
+/**
+ * Ticks every behaviors/test_*.xml tree against synthetic games of several sizes, one of them with
+ * enemies leaving and coming back into view, and against games recorded with MyStrategy's RECORD,
+ * and reports the cost of a tick, the heap allocations per tick and a hash of all orders, which
+ * changes whenever a decision does.
+ *
+ * The same games also go through the whole cycle of MyStrategy with the main behavior: decoding
+ * the game, ticking every own unit and encoding the order. With --fail-on-alloc all games are
+ * played twice and the benchmark fails if any tick of the second time allocates after the warm-up,
+ * in a tree or in that cycle. The allocations of the first time after the warm-up are reported
+ * too, they show what the buffers cost until they fit.
+ *
+ * Usage: behavior_bench [--behaviors DIR] [--ticks N] [--games RECORDING]... [--fail-on-alloc]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "MyStrategy.hpp"
+#include "codegame/ClientMessage.hpp"
+#include "model/Constants.hpp"
+#include "model/Game.hpp"
+#include "tree/UnitController.h"
+#include "utils/FileStream.h"
+#include "utils/MemoryStream.h"
+#include "world/DangerMap.h"
+#include "world/DerivedConstants.h"
+#include "world/GameGenerator.h"
+#include "world/ObstacleIndex.h"
+#include "world/StrategyParameters.h"
+#include "world/ZonePredictor.h"
+
+using namespace std;
+using namespace model;
+
+namespace {
+
+atomic<uint64_t> allocations = 0;
+
+constexpr auto WARMUP_TICKS = 10;
+constexpr auto SPAWN_RADIUS = 80.0;
+constexpr auto ENEMY_COUNTS = {1, 10, 100};
+constexpr auto PROJECTILE_COUNTS = {0, 200, 2000};
+constexpr auto HIDING_ENEMIES = 10;
+constexpr auto VISIBILITY_PERIOD = 40; // ticks
+
+} // namespace
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (auto *pointer = malloc(size ? size : 1))
+        return pointer;
+    throw bad_alloc{};
+}
+
+void *operator new(size_t size, align_val_t alignment)
+{
+    allocations.fetch_add(1, memory_order_relaxed);
+    const auto align = static_cast<size_t>(alignment);
+    if (auto *pointer = aligned_alloc(align, (max(size, size_t{1}) + align - 1) / align * align))
+        return pointer;
+    throw bad_alloc{};
+}
+
+void operator delete(void *pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void *pointer, align_val_t) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t, align_val_t) noexcept
+{
+    free(pointer);
+}
+
+namespace {
+
+using GameSource = function<optional<Game>()>;
+// starts the same games from the beginning on every call
+using GameSources = function<GameSource()>;
+
+struct Result
+{
+    int ticks = 0;
+    int measured = 0;
+    chrono::nanoseconds elapsed{0};
+    uint64_t allocations = 0;
+    // allocations of the first pass after the warm-up, when there are several
+    optional<uint64_t> firstPassAllocations;
+    uint64_t hash = 14695981039346656037ull;
+    string error;
+};
+
+// plays the games the given number of times, measuring the last time
+using Benchmark = Result(const Constants &, const GameSources &, int passes);
+
+/**
+ * Calls @p timed and adds its duration and allocations to @p result, unless it's a warm-up tick.
+ */
+template<typename Timed>
+void measure(Result &result, Timed &&timed)
+{
+    const auto allocationsBefore = allocations.load(memory_order_relaxed);
+    const auto start = chrono::steady_clock::now();
+    timed();
+    const auto duration = chrono::steady_clock::now() - start;
+    const auto tickAllocations = allocations.load(memory_order_relaxed) - allocationsBefore;
+
+    if (result.ticks++ >= WARMUP_TICKS) {
+        result.elapsed += duration;
+        result.allocations += tickAllocations;
+        ++result.measured;
+    }
+}
+
+/**
+ * Clears @p result for pass @p pass, keeping the allocations of the first pass.
+ */
+void startPass(Result &result, int pass)
+{
+    const auto firstPassAllocations = pass == 1 ? optional{result.allocations}
+                                                : result.firstPassAllocations;
+    result = {};
+    result.firstPassAllocations = firstPassAllocations;
+}
+
+void hashBytes(uint64_t &hash, const void *data, size_t size)
+{
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+}
+
+void hashOrder(uint64_t &hash, const optional<UnitOrder> &order)
+{
+    const auto present = order.has_value();
+    hashBytes(hash, &present, sizeof(present));
+    if (!order)
+        return;
+
+    const double values[] = {order->targetVelocity.x,
+                             order->targetVelocity.y,
+                             order->targetDirection.x,
+                             order->targetDirection.y};
+    hashBytes(hash, values, sizeof(values));
+    const auto action = order->action ? order->action.value()->toString() : string{};
+    hashBytes(hash, action.data(), action.size());
+}
+
+/**
+ * Own unit with its enemies spawned around it, so they see each other, and projectiles flying
+ * from random units, replaced when they expire so their number stays the same.
+ */
+GameGenerator::Settings syntheticSettings(int enemyCount, int projectileCount)
+{
+    GameGenerator::Settings settings;
+    settings.seed = 42;
+    settings.units = enemyCount + 1;
+    settings.projectiles = projectileCount;
+    settings.spawnRadius = SPAWN_RADIUS;
+    return settings;
+}
+
+GameSources syntheticGames(const GameGenerator::Settings &settings, int ticks)
+{
+    return [settings, ticks]() -> GameSource {
+        auto generator = make_shared<GameGenerator>(settings);
+        return [generator, ticks, tick = 0]() mutable -> optional<Game> {
+            if (tick++ == ticks)
+                return nullopt;
+            return generator->next();
+        };
+    };
+}
+
+GameSources recordedGames(const string &path)
+{
+    return [path]() -> GameSource {
+        auto stream = make_shared<FileStream>(path, ios::in);
+        Constants::readFrom(*stream);
+        return [stream]() -> optional<Game> {
+            if (stream->atEnd())
+                return nullopt;
+            return Game::readFrom(*stream);
+        };
+    };
+}
+
+Result run(const string &behaviorsPath,
+           const string &file,
+           const Constants &constants,
+           const GameSources &games,
+           int passes)
+{
+    const DerivedConstants derived{constants};
+    const StrategyParameters parameters;
+    Game game;
+    EnemyMap enemies;
+    DangerMap dangerMap{derived};
+    ZonePredictor zonePredictor{derived};
+    ObstacleIndex obstacleIndex{constants};
+
+    try {
+        UnitController controller{derived, parameters, game, enemies, zonePredictor,
+                                  obstacleIndex, dangerMap, behaviorsPath, file, false};
+
+        Result result;
+        for (auto pass = 0; pass < passes; ++pass) {
+            startPass(result, pass);
+            auto source = games();
+            while (auto next = source()) {
+                game = move(next.value());
+                enemies.clear();
+                const Unit *own = nullptr;
+                for (auto &unit : game.units) {
+                    if (unit.playerId != game.myId)
+                        enemies.emplace(unit.id, SeenEnemy{ref(unit), game.currentTick});
+                    else if (!own)
+                        own = &unit;
+                }
+                dangerMap.update(game);
+                zonePredictor.update(game.zone, game.currentTick);
+                if (!own)
+                    continue;
+
+                optional<UnitOrder> order;
+                measure(result, [&] { order = controller.tick(*own); });
+                hashOrder(result.hash, order);
+            }
+        }
+        return result;
+    } catch (const exception &e) {
+        Result result;
+        result.error = e.what();
+        return result;
+    }
+}
+
+/**
+ * Same cycle as the client's main loop, with the network replaced by memory streams.
+ */
+Result runStrategy(const string &behaviorsPath,
+                   const Constants &constants,
+                   const GameSources &games,
+                   int passes)
+{
+    try {
+        MyStrategy strategy{constants, {}, behaviorsPath};
+        MemoryStream input;
+        MemoryStream output;
+
+        Result result;
+        for (auto pass = 0; pass < passes; ++pass) {
+            startPass(result, pass);
+            auto source = games();
+            while (auto next = source()) {
+                input.clear();
+                next->writeTo(input);
+                output.clear();
+
+                measure(result, [&] {
+                    Game::readFrom(input, strategy.nextGame());
+                    const auto &order = strategy.getOrder(nullptr);
+                    output.write(codegame::ClientMessage::OrderMessage::TAG);
+                    order.writeTo(output);
+                });
+                hashBytes(result.hash, output.data().data(), output.data().size());
+            }
+        }
+        return result;
+    } catch (const exception &e) {
+        Result result;
+        result.error = e.what();
+        return result;
+    }
+}
+
+void print(const string &tree, const string &scenario, const Result &result)
+{
+    cout << left << setw(28) << tree << setw(30) << scenario << right;
+    if (!result.error.empty()) {
+        cout << "  error: " << result.error << endl;
+        return;
+    }
+    const auto measured = max(result.measured, 1);
+    const auto nanosecondsPerTick = static_cast<double>(result.elapsed.count()) / measured;
+    const auto allocationsPerTick = static_cast<double>(result.allocations) / measured;
+    cout << setw(8) << result.ticks << setw(12) << fixed << setprecision(0) << nanosecondsPerTick
+         << setw(12) << setprecision(2) << allocationsPerTick;
+    if (result.firstPassAllocations)
+        cout << setw(16) << result.firstPassAllocations.value();
+    cout << "  " << hex << setw(16) << setfill('0') << result.hash << dec << setfill(' ') << endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    string behaviorsPath = BENCH_BEHAVIORS_PATH;
+    auto ticks = 300;
+    vector<string> recordings;
+    auto failOnAllocation = false;
+    for (auto i = 1; i < argc; ++i) {
+        const string argument = argv[i];
+        if (argument == "--behaviors" && i + 1 < argc) {
+            behaviorsPath = argv[++i];
+            if (behaviorsPath.back() != '/')
+                behaviorsPath += '/';
+        } else if (argument == "--ticks" && i + 1 < argc) {
+            ticks = stoi(argv[++i]);
+        } else if (argument == "--games" && i + 1 < argc) {
+            recordings.emplace_back(argv[++i]);
+        } else if (argument == "--fail-on-alloc") {
+            failOnAllocation = true;
+        } else {
+            cerr << "usage: " << argv[0]
+                 << " [--behaviors DIR] [--ticks N] [--games RECORDING]... [--fail-on-alloc]"
+                 << endl;
+            return 2;
+        }
+    }
+
+    vector<string> trees;
+    for (const auto &entry : filesystem::directory_iterator{behaviorsPath}) {
+        const auto name = entry.path().filename().string();
+        if (name.starts_with("test_") && entry.path().extension() == ".xml")
+            trees.push_back(name);
+    }
+    sort(begin(trees), end(trees));
+
+    cout << left << setw(28) << "tree" << setw(30) << "game" << right << setw(8) << "ticks"
+         << setw(12) << "ns/tick" << setw(12) << "allocs/tick";
+    if (failOnAllocation)
+        cout << setw(16) << "1st pass allocs";
+    cout << "  " << "decision hash" << endl;
+
+    // buffers only grow until they fit the largest state, so the games are played once to warm
+    // them up before the pass in which nothing may allocate
+    const auto passes = failOnAllocation ? 2 : 1;
+    // runs that allocated after the warm-up or couldn't run at all
+    auto failedRuns = 0;
+    const auto benchmarkAll = [&](const string &name, const function<Benchmark> &benchmark) {
+        const auto report = [&](const string &scenario, const Result &result) {
+            print(name, scenario, result);
+            if (failOnAllocation && (!result.error.empty() || result.allocations > 0))
+                ++failedRuns;
+        };
+
+        for (const auto enemies : ENEMY_COUNTS) {
+            for (const auto projectiles : PROJECTILE_COUNTS) {
+                const auto scenario = to_string(enemies) + " enemies, " + to_string(projectiles)
+                                      + " projectiles";
+                const auto settings = syntheticSettings(enemies, projectiles);
+                const GameGenerator generator{settings};
+                report(scenario,
+                       benchmark(generator.constants(), syntheticGames(settings, ticks), passes));
+            }
+        }
+
+        // enemies leaving and coming back into view, which drops and adds their state
+        auto hiding = syntheticSettings(HIDING_ENEMIES, 0);
+        hiding.visibilityPeriod = VISIBILITY_PERIOD;
+        const GameGenerator generator{hiding};
+        report(to_string(HIDING_ENEMIES) + " enemies leaving view",
+               benchmark(generator.constants(), syntheticGames(hiding, ticks), passes));
+
+        for (const auto &recording : recordings) {
+            FileStream stream{recording, ios::in};
+            const auto recorded = Constants::readFrom(stream);
+            const auto scenario = filesystem::path{recording}.filename().string();
+            report(scenario, benchmark(recorded, recordedGames(recording), passes));
+        }
+    };
+
+    for (const auto &tree : trees) {
+        benchmarkAll(tree, [&](const Constants &constants, const GameSources &games, int passes) {
+            return run(behaviorsPath, tree, constants, games, passes);
+        });
+    }
+    benchmarkAll("MyStrategy", [&](const Constants &constants, const GameSources &games, int passes) {
+        return runStrategy(behaviorsPath, constants, games, passes);
+    });
+
+    if (failOnAllocation && failedRuns > 0) {
+        cerr << failedRuns << " runs allocated after the warm-up or failed" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+/**
+ * Writes constants and consecutive games made by GameGenerator to a file, in the same format as
+ * MyStrategy's RECORD, so they can be replayed with `behavior_bench --games`.
+ *
+ * Usage: generate_games --output FILE [--seed N] [--ticks N] [--units N] [--team-size N]
+ *                       [--projectiles N] [--obstacles N] [--zone-radius R] [--spawn-radius R]
+ */
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "utils/FileStream.h"
+#include "world/GameGenerator.h"
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    GameGenerator::Settings settings;
+    string output;
+    auto ticks = 300;
+    try {
+        for (auto i = 1; i < argc; ++i) {
+            const string argument = argv[i];
+            if (i + 1 == argc)
+                throw invalid_argument{argument};
+
+            const string value = argv[++i];
+            if (argument == "--output")
+                output = value;
+            else if (argument == "--seed")
+                settings.seed = stoul(value);
+            else if (argument == "--ticks")
+                ticks = stoi(value);
+            else if (argument == "--units")
+                settings.units = stoi(value);
+            else if (argument == "--team-size")
+                settings.teamSize = stoi(value);
+            else if (argument == "--projectiles")
+                settings.projectiles = stoi(value);
+            else if (argument == "--obstacles")
+                settings.obstacles = stoi(value);
+            else if (argument == "--zone-radius")
+                settings.zoneRadius = stod(value);
+            else if (argument == "--spawn-radius")
+                settings.spawnRadius = stod(value);
+            else
+                throw invalid_argument{argument};
+        }
+        if (output.empty())
+            throw invalid_argument{"--output"};
+    } catch (const logic_error &) {
+        cerr << "usage: " << argv[0]
+             << " --output FILE [--seed N] [--ticks N] [--units N] [--team-size N]"
+                " [--projectiles N] [--obstacles N] [--zone-radius R] [--spawn-radius R]"
+             << endl;
+        return 2;
+    }
+
+    try {
+        GameGenerator generator{settings};
+        FileStream stream{output, ios::out | ios::trunc};
+        generator.constants().writeTo(stream);
+        for (auto tick = 0; tick < ticks; ++tick)
+            generator.next().writeTo(stream);
+        stream.flush();
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
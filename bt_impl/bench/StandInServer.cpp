@@ -0,0 +1,251 @@
+/**
+ * Stands in for the game server where it isn't available: accepts a client on a port, checks
+ * its token and plays a game with it over the same protocol, from a recording of MyStrategy's
+ * RECORD or simulated by GameGenerator. Then reports how long the client took to answer each
+ * tick, from sending the game to receiving the whole order, so TCP is included.
+ *
+ * Every game is played over a new connection like with the real server, so a client that plays
+ * one game per process has to be started once per game. Recordings are played in the given order,
+ * --repeat plays all of them, or the simulated game, several times.
+ *
+ * Usage: stand_in_server [--port N] [--token TOKEN] [--games RECORDING]... [--repeat N]
+ *                        [--latencies FILE] [--seed N] [--ticks N] [--units N] [--team-size N]
+ *                        [--projectiles N] [--obstacles N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TcpStream.hpp"
+#include "codegame/ClientMessage.hpp"
+#include "codegame/ServerMessage.hpp"
+#include "model/Constants.hpp"
+#include "model/Game.hpp"
+#include "utils/FileStream.h"
+#include "utils/MemoryStream.h"
+#include "utils/TcpListener.h"
+#include "world/GameGenerator.h"
+
+using namespace std;
+using namespace model;
+
+namespace {
+
+using GameSource = function<optional<Game>()>;
+
+struct Match
+{
+    string name;
+    // constants and a source of the games from the beginning, on every call
+    function<pair<Constants, GameSource>()> open;
+};
+
+Match simulatedMatch(const GameGenerator::Settings &settings, int ticks)
+{
+    return {"simulated", [settings, ticks]() {
+                auto generator = make_shared<GameGenerator>(settings);
+                auto constants = generator->constants();
+                GameSource games = [generator, ticks, tick = 0]() mutable -> optional<Game> {
+                    if (tick++ == ticks)
+                        return nullopt;
+                    return generator->next();
+                };
+                return make_pair(move(constants), move(games));
+            }};
+}
+
+Match recordedMatch(const string &path)
+{
+    return {path, [path]() {
+                auto stream = make_shared<FileStream>(path, ios::in);
+                auto constants = Constants::readFrom(*stream);
+                GameSource games = [stream]() -> optional<Game> {
+                    if (stream->atEnd())
+                        return nullopt;
+                    return Game::readFrom(*stream);
+                };
+                return make_pair(move(constants), move(games));
+            }};
+}
+
+void acceptHandshake(TcpStream &client, const string &token)
+{
+    if (client.readString() != token)
+        throw runtime_error("Wrong token");
+    // protocol version and options, any client of this repository sends the same
+    for (auto i = 0; i < 3; ++i)
+        client.readInt();
+}
+
+void readOrder(TcpStream &client)
+{
+    while (true) {
+        switch (client.readInt()) {
+        case codegame::ClientMessage::OrderMessage::TAG:
+            codegame::ClientMessage::OrderMessage::readFrom(client);
+            return;
+        case codegame::ClientMessage::DebugMessage::TAG:
+            // debug isn't available, a client sending commands anyway only wastes its time
+            codegame::ClientMessage::DebugMessage::readFrom(client);
+            break;
+        default:
+            throw runtime_error("Unexpected client message");
+        }
+    }
+}
+
+/**
+ * @return Time the client took to answer every tick.
+ */
+vector<chrono::nanoseconds> play(TcpStream &client, const Constants &constants, GameSource &games)
+{
+    codegame::ServerMessage::UpdateConstants{constants}.writeTo(client);
+    client.flush();
+
+    // encoded before the clock starts, so only the client and the connection are measured
+    MemoryStream message;
+    vector<chrono::nanoseconds> latencies;
+    while (const auto game = games()) {
+        // same encoding as ServerMessage::GetOrder, which would copy the game
+        message.clear();
+        message.write(codegame::ServerMessage::GetOrder::TAG);
+        game->writeTo(message);
+        message.write(false);
+
+        const auto start = chrono::steady_clock::now();
+        client.writeBytes(message.data().data(), message.data().size());
+        client.flush();
+        readOrder(client);
+        latencies.push_back(chrono::steady_clock::now() - start);
+    }
+
+    codegame::ServerMessage::Finish{}.writeTo(client);
+    client.flush();
+    return latencies;
+}
+
+double percentile(vector<chrono::nanoseconds> latencies, double fraction)
+{
+    if (latencies.empty())
+        return 0;
+    const auto index = min(static_cast<size_t>(fraction * latencies.size()), latencies.size() - 1);
+    nth_element(begin(latencies), begin(latencies) + index, end(latencies));
+    return latencies[index].count() / 1000.0;
+}
+
+void report(const string &name, const vector<chrono::nanoseconds> &latencies)
+{
+    auto total = chrono::nanoseconds{0};
+    for (const auto latency : latencies)
+        total += latency;
+    const auto mean = latencies.empty() ? 0.0 : total.count() / 1000.0 / latencies.size();
+
+    cout << left << setw(30) << name << right << setw(8) << latencies.size() << fixed
+         << setprecision(0) << setw(10) << mean << setw(10) << percentile(latencies, 0.5)
+         << setw(10) << percentile(latencies, 0.9) << setw(10) << percentile(latencies, 0.99)
+         << setw(10) << percentile(latencies, 1.0) << endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    auto port = 31001;
+    string token = "0000000000000000";
+    vector<string> recordings;
+    auto repeat = 1;
+    string latenciesPath;
+    GameGenerator::Settings settings;
+    auto ticks = 1000;
+    try {
+        for (auto i = 1; i < argc; ++i) {
+            const string argument = argv[i];
+            if (i + 1 == argc)
+                throw invalid_argument{argument};
+
+            const string value = argv[++i];
+            if (argument == "--port")
+                port = stoi(value);
+            else if (argument == "--token")
+                token = value;
+            else if (argument == "--games")
+                recordings.push_back(value);
+            else if (argument == "--repeat")
+                repeat = stoi(value);
+            else if (argument == "--latencies")
+                latenciesPath = value;
+            else if (argument == "--seed")
+                settings.seed = stoul(value);
+            else if (argument == "--ticks")
+                ticks = stoi(value);
+            else if (argument == "--units")
+                settings.units = stoi(value);
+            else if (argument == "--team-size")
+                settings.teamSize = stoi(value);
+            else if (argument == "--projectiles")
+                settings.projectiles = stoi(value);
+            else if (argument == "--obstacles")
+                settings.obstacles = stoi(value);
+            else
+                throw invalid_argument{argument};
+        }
+    } catch (const logic_error &) {
+        cerr << "usage: " << argv[0]
+             << " [--port N] [--token TOKEN] [--games RECORDING]... [--repeat N]"
+                " [--latencies FILE] [--seed N] [--ticks N] [--units N] [--team-size N]"
+                " [--projectiles N] [--obstacles N]"
+             << endl;
+        return 2;
+    }
+
+    vector<Match> matches;
+    for (const auto &recording : recordings)
+        matches.push_back(recordedMatch(recording));
+    if (matches.empty())
+        matches.push_back(simulatedMatch(settings, ticks));
+
+    try {
+        TcpListener listener{port};
+        optional<ofstream> latenciesFile;
+        if (!latenciesPath.empty()) {
+            latenciesFile.emplace(latenciesPath, ios::trunc);
+            *latenciesFile << "game,tick,microseconds\n";
+        }
+
+        cout << left << setw(30) << "game" << right << setw(8) << "ticks" << setw(10) << "mean us"
+             << setw(10) << "p50 us" << setw(10) << "p90 us" << setw(10) << "p99 us" << setw(10)
+             << "max us" << endl;
+        auto gameIndex = 0;
+        for (auto pass = 0; pass < repeat; ++pass) {
+            for (const auto &match : matches) {
+                auto [constants, games] = match.open();
+                const auto client = listener.accept();
+                acceptHandshake(*client, token);
+                const auto latencies = play(*client, constants, games);
+
+                report(match.name, latencies);
+                if (latenciesFile) {
+                    for (size_t tick = 0; tick < latencies.size(); ++tick) {
+                        *latenciesFile << gameIndex << ',' << tick << ','
+                                       << latencies[tick].count() / 1000.0 << '\n';
+                    }
+                }
+                ++gameIndex;
+            }
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include "TreeProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <numeric>
+
+using namespace std;
+using namespace BT;
+
+namespace {
+
+void writeEscaped(ostream &out, const string &text)
+{
+    for (const auto c : text) {
+        if (c == '"' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+}
+
+} // namespace
+
+TreeProfiler::TreeProfiler(const Tree &tree)
+    : StatusChangeLogger{tree.rootNode()}, m_records{make_unique<Record[]>(CAPACITY)}
+{
+    enableTransitionToIdle(false);
+
+    uint16_t lastUid = 0;
+    m_firstUid = UINT16_MAX;
+    for (const auto &node : tree.nodes) {
+        m_firstUid = min(m_firstUid, node->UID());
+        lastUid = max(lastUid, node->UID());
+    }
+    if (tree.nodes.empty())
+        m_firstUid = 0;
+
+    m_names.resize(lastUid - m_firstUid + 1);
+    m_stats.resize(m_names.size());
+    for (const auto &node : tree.nodes)
+        m_names[node->UID() - m_firstUid] = node->name();
+}
+
+void TreeProfiler::beginTick()
+{
+    m_last = now();
+    m_tickStart = m_last;
+    ++m_ticks;
+    record(m_last, TICK_MARKER, NodeStatus::IDLE, NodeStatus::IDLE);
+}
+
+void TreeProfiler::endTick()
+{
+    m_tickNanoseconds += now() - m_tickStart;
+}
+
+void TreeProfiler::callback(Duration timestamp,
+                            const TreeNode &node,
+                            NodeStatus previous,
+                            NodeStatus status)
+{
+    const auto time = chrono::duration_cast<chrono::nanoseconds>(timestamp).count();
+    auto &stats = m_stats[node.UID() - m_firstUid];
+    stats.nanoseconds += time - m_last;
+    ++stats.transitions[static_cast<size_t>(status)];
+    m_last = time;
+
+    record(time, node.UID(), previous, status);
+}
+
+void TreeProfiler::flush() {}
+
+int64_t TreeProfiler::now()
+{
+    // the clock and origin of the timestamps BehaviorTree.CPP passes by default
+    const auto sinceEpoch = TimePoint::clock::now().time_since_epoch();
+    return chrono::duration_cast<chrono::nanoseconds>(sinceEpoch).count();
+}
+
+void TreeProfiler::record(int64_t timestamp, uint16_t uid, NodeStatus previous, NodeStatus status)
+{
+    const auto head = m_head.load(memory_order_relaxed);
+    m_records[head % CAPACITY] = Record{timestamp, uid, previous, status};
+    m_head.store(head + 1, memory_order_release);
+}
+
+void TreeProfiler::report(ostream &out) const
+{
+    out << "behavior tree profile, " << m_ticks << " ticks\n";
+    out << left << setw(24) << "node" << right << setw(10) << "running" << setw(10) << "success"
+        << setw(10) << "failure" << setw(14) << "total us" << setw(12) << "ns/update" << '\n';
+
+    for (size_t i = 0; i < m_stats.size(); ++i) {
+        const auto &stats = m_stats[i];
+        const auto running = stats.transitions[static_cast<size_t>(NodeStatus::RUNNING)];
+        const auto success = stats.transitions[static_cast<size_t>(NodeStatus::SUCCESS)];
+        const auto failure = stats.transitions[static_cast<size_t>(NodeStatus::FAILURE)];
+        const auto updates = running + success + failure;
+        if (updates == 0)
+            continue;
+
+        const auto total = static_cast<double>(stats.nanoseconds);
+        out << left << setw(24) << m_names[i] << right << setw(10) << running << setw(10)
+            << success << setw(10) << failure << setw(14) << fixed << setprecision(1)
+            << total / 1000 << setw(12) << total / updates << '\n';
+    }
+
+    const auto nodeNanoseconds = accumulate(cbegin(m_stats),
+                                            cend(m_stats),
+                                            int64_t{0},
+                                            [](int64_t sum, const NodeStats &stats) {
+                                                return sum + stats.nanoseconds;
+                                            });
+    out << "nodes " << fixed << setprecision(1) << nodeNanoseconds / 1000.0 << " us of "
+        << m_tickNanoseconds / 1000.0 << " us ticked\n";
+    if (nodeNanoseconds > m_tickNanoseconds)
+        out << "node times exceed the tick times, the timestamps have another origin\n";
+    out.flush();
+}
+
+void TreeProfiler::exportChromeTrace(ostream &out) const
+{
+    const auto head = m_head.load(memory_order_acquire);
+    const auto first = head > CAPACITY ? head - CAPACITY : 0;
+
+    // relative to the oldest record, absolute timestamps would lose the fractions of microseconds
+    const auto origin = head > first ? m_records[first % CAPACITY].timestamp : 0;
+    out << "{\"traceEvents\":[";
+    auto separator = "";
+    for (auto i = first + 1; i < head; ++i) {
+        const auto &previous = m_records[(i - 1) % CAPACITY];
+        const auto &current = m_records[i % CAPACITY];
+        if (current.uid == TICK_MARKER)
+            continue;
+
+        out << separator << "{\"name\":\"";
+        writeEscaped(out, m_names[current.uid - m_firstUid]);
+        out << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":" << fixed << setprecision(3)
+            << (previous.timestamp - origin) / 1000.0
+            << ",\"dur\":" << (current.timestamp - previous.timestamp) / 1000.0
+            << ",\"args\":{\"from\":\"" << toStr(current.previous) << "\",\"to\":\""
+            << toStr(current.status) << "\"}}";
+        separator = ",";
+    }
+    out << "]}\n";
+}
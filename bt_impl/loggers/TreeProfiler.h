@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <behaviortree_cpp_v3/loggers/abstract_logger.h>
+
+/**
+ * Status change logger cheap enough to stay enabled in production.
+ *
+ * Every transition is written to a fixed size ring buffer as (timestamp, node uid, old and new
+ * status) and added to per-node counters, nothing is formatted or allocated while the tree ticks.
+ * The buffer is single-producer: only the ticking thread writes, and the head index is published
+ * with release semantics for a reader on another thread.
+ *
+ * Transitions are stamped with the time BehaviorTree.CPP passes to the callback, which it reads
+ * for every status change whether anyone listens or not, so the profiler itself reads the clock
+ * only at the start and the end of a tick. By default the library passes the time since the epoch
+ * of its clock, the tick marks use the same origin.
+ *
+ * BehaviorTree.CPP reports status changes only, so the counters count transitions rather than
+ * ticks: a node RUNNING for several ticks is counted once. The time between two consecutive
+ * transitions, or the tick start and the first transition, is attributed to the node of the later
+ * one, which is the self time of leaves and the bookkeeping overhead of control nodes. Node times
+ * add up to at most the time between the start and the end of the ticks, the report says if they
+ * don't.
+ */
+class TreeProfiler : public BT::StatusChangeLogger
+{
+public:
+    explicit TreeProfiler(const BT::Tree &tree);
+
+    /**
+     * Marks the start of a tick, so the time spent outside the tree isn't attributed to nodes.
+     */
+    void beginTick();
+    void endTick();
+
+    virtual void callback(BT::Duration timestamp,
+                          const BT::TreeNode &node,
+                          BT::NodeStatus previous,
+                          BT::NodeStatus status) override;
+    virtual void flush() override;
+
+    /**
+     * Prints per-node counters as a table.
+     */
+    void report(std::ostream &out) const;
+    /**
+     * Writes the buffered transitions in Chrome trace event format, viewable in chrome://tracing
+     * or Perfetto.
+     */
+    void exportChromeTrace(std::ostream &out) const;
+
+private:
+    struct Record
+    {
+        // nanoseconds since the epoch of BT::TimePoint
+        int64_t timestamp;
+        uint16_t uid;
+        BT::NodeStatus previous;
+        BT::NodeStatus status;
+    };
+
+    struct NodeStats
+    {
+        int64_t nanoseconds = 0;
+        std::array<uint64_t, 4> transitions{};
+    };
+
+    static constexpr size_t CAPACITY = 1 << 16; // records
+    static constexpr uint16_t TICK_MARKER = UINT16_MAX;
+
+    static int64_t now();
+
+    void record(int64_t timestamp, uint16_t uid, BT::NodeStatus previous, BT::NodeStatus status);
+
+private:
+    uint16_t m_firstUid = 0;
+    std::vector<std::string> m_names;
+    std::vector<NodeStats> m_stats;
+    uint64_t m_ticks = 0;
+    int64_t m_last = 0;
+    int64_t m_tickStart = 0;
+    // sum of the time between the start and the end of every tick
+    int64_t m_tickNanoseconds = 0;
+
+    std::unique_ptr<Record[]> m_records;
+    std::atomic<uint64_t> m_head = 0;
+};
@@ -3,15 +3,52 @@
 #include "TcpStream.hpp"
 #include "codegame/ClientMessage.hpp"
 #include "codegame/ServerMessage.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
 using namespace std;
 
+// file of strategy parameters read for every game, lets a trainer change them between games
+constexpr auto PARAMETERS_VARIABLE = "STRATEGY_PARAMETERS";
+// rebuilds the behavior tree when its file changes if set to anything but 0, like --hot-reload
+constexpr auto HOT_RELOAD_VARIABLE = "BEHAVIOR_HOT_RELOAD";
+// file the client writes the ticks and the time of every game to when it finishes, lets a trainer
+// follow the client's speed
+constexpr auto TIMING_VARIABLE = "CLIENT_TIMING";
+
+/**
+ * @return Defaults overridden by the file in PARAMETERS_VARIABLE, then by @p files, then by
+ * @p assignments.
+ */
+StrategyParameters loadParameters(const std::vector<std::string> &files,
+                                  const std::vector<std::string> &assignments)
+{
+    StrategyParameters parameters;
+    if (const auto *file = getenv(PARAMETERS_VARIABLE); file && *file)
+        parameters.load(file);
+    for (const auto &file : files)
+        parameters.load(file);
+    for (const auto &assignment : assignments)
+        parameters.set(assignment);
+    return parameters;
+}
+
 class Runner
 {
 public:
-    Runner(const std::string &host, int port, const std::string &token) : tcpStream(host, port)
+    Runner(const std::string &host,
+           int port,
+           const std::string &token,
+           std::vector<std::string> parameterFiles,
+           std::vector<std::string> parameterAssignments,
+           bool hotReload)
+        : tcpStream(host, port), parameterFiles(std::move(parameterFiles)),
+          parameterAssignments(std::move(parameterAssignments)), hotReload(hotReload)
     {
         tcpStream.write(token);
         tcpStream.write(int(1));
@@ -24,42 +61,127 @@ public:
         DebugInterface debugInterface(&tcpStream);
         std::shared_ptr<MyStrategy> myStrategy = std::shared_ptr<MyStrategy>();
         while (true) {
-            auto message = codegame::ServerMessage::readFrom(tcpStream);
-            if (auto updateConstantsMessage
-                = std::dynamic_pointer_cast<codegame::ServerMessage::UpdateConstants>(message)) {
-                myStrategy.reset(new MyStrategy(updateConstantsMessage->constants));
-            } else if (auto getOrderMessage
-                       = std::dynamic_pointer_cast<codegame::ServerMessage::GetOrder>(message)) {
-                codegame::ClientMessage::OrderMessage(
-                    myStrategy->getOrder(move(getOrderMessage->playerView),
-                                         getOrderMessage->debugAvailable ? &debugInterface
-                                                                         : nullptr))
-                    .writeTo(tcpStream);
+            switch (tcpStream.readInt()) {
+            case codegame::ServerMessage::UpdateConstants::TAG: {
+                auto message = codegame::ServerMessage::UpdateConstants::readFrom(tcpStream);
+                myStrategy.reset(new MyStrategy(std::move(message.constants),
+                                                parameters(),
+                                                BEHAVIORS_PATH,
+                                                hotReload));
+                gameStart = Clock::now();
+                clientTime = {};
+                ticks = 0;
+                break;
+            }
+            case codegame::ServerMessage::GetOrder::TAG: {
+                const auto tickStart = Clock::now();
+                // decoded into the tick arena of the strategy, so a tick doesn't allocate
+                model::Game::readFrom(tcpStream, myStrategy->nextGame());
+                const auto debugAvailable = tcpStream.readBool();
+                const auto &order = myStrategy->getOrder(debugAvailable ? &debugInterface
+                                                                        : nullptr);
+                // same encoding as ClientMessage::OrderMessage, which would copy the order
+                tcpStream.write(codegame::ClientMessage::OrderMessage::TAG);
+                order.writeTo(tcpStream);
                 tcpStream.flush();
-            } else if (auto finishMessage
-                       = std::dynamic_pointer_cast<codegame::ServerMessage::Finish>(message)) {
-                myStrategy->finish();
+                clientTime += Clock::now() - tickStart;
+                ++ticks;
                 break;
-            } else if (auto debugUpdateMessage
-                       = std::dynamic_pointer_cast<codegame::ServerMessage::DebugUpdate>(message)) {
-                myStrategy->debugUpdate(debugUpdateMessage->displayedTick, debugInterface);
+            }
+            case codegame::ServerMessage::Finish::TAG:
+                myStrategy->finish();
+                writeTiming();
+                return;
+            case codegame::ServerMessage::DebugUpdate::TAG: {
+                const auto message = codegame::ServerMessage::DebugUpdate::readFrom(tcpStream);
+                myStrategy->debugUpdate(message.displayedTick, debugInterface);
                 codegame::ClientMessage::DebugUpdateDone().writeTo(tcpStream);
                 tcpStream.flush();
-            } else {
+                break;
+            }
+            default:
                 throw std::runtime_error("Unexpected server message");
             }
         }
     }
 
 private:
+    StrategyParameters parameters() const
+    {
+        return loadParameters(parameterFiles, parameterAssignments);
+    }
+
+    /**
+     * Writes the ticks of the game, its seconds and the seconds spent on the ticks as name=value
+     * lines to the file in TIMING_VARIABLE, if set.
+     */
+    void writeTiming() const
+    {
+        const auto *path = getenv(TIMING_VARIABLE);
+        if (!path || !*path)
+            return;
+
+        const auto seconds = [](Clock::duration duration) {
+            return std::chrono::duration<double>(duration).count();
+        };
+        std::ofstream file{path, std::ios::trunc};
+        file << "ticks=" << ticks << '\n'
+             << "game_seconds=" << seconds(Clock::now() - gameStart) << '\n'
+             << "client_seconds=" << seconds(clientTime) << '\n';
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
     TcpStream tcpStream;
+    std::vector<std::string> parameterFiles;
+    std::vector<std::string> parameterAssignments;
+    bool hotReload;
+    // of the current game, from decoding a tick to sending its order
+    Clock::time_point gameStart;
+    Clock::duration clientTime{};
+    int ticks = 0;
 };
 
+// usage: ai_cup_22 [host [port [token]]] [--parameters FILE]... [--set name=value]...
+//                  [--hot-reload] [--list-parameters]
+// --list-parameters prints the strategy parameters with the values a game would get and exits
 int main(int argc, char *argv[])
 {
-    std::string host = argc < 2 ? "127.0.0.1" : argv[1];
-    int port = argc < 3 ? 31001 : atoi(argv[2]);
-    std::string token = argc < 4 ? "0000000000000000" : argv[3];
-    Runner(host, port, token).run();
+    std::vector<std::string> positional;
+    std::vector<std::string> parameterFiles;
+    std::vector<std::string> parameterAssignments;
+    const auto *hotReloadValue = getenv(HOT_RELOAD_VARIABLE);
+    bool hotReload = hotReloadValue && *hotReloadValue && std::string{hotReloadValue} != "0";
+    bool listParameters = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--hot-reload")
+            hotReload = true;
+        else if (argument == "--list-parameters")
+            listParameters = true;
+        else if (argument == "--parameters" && i + 1 < argc)
+            parameterFiles.emplace_back(argv[++i]);
+        else if (argument == "--set" && i + 1 < argc)
+            parameterAssignments.emplace_back(argv[++i]);
+        else
+            positional.push_back(argument);
+    }
+
+    if (listParameters) {
+        loadParameters(parameterFiles, parameterAssignments).write(std::cout);
+        return 0;
+    }
+
+    std::string host = positional.size() < 1 ? "127.0.0.1" : positional[0];
+    int port = positional.size() < 2 ? 31001 : atoi(positional[1].c_str());
+    std::string token = positional.size() < 3 ? "0000000000000000" : positional[2];
+    Runner(host,
+           port,
+           token,
+           std::move(parameterFiles),
+           std::move(parameterAssignments),
+           hotReload)
+        .run();
     return 0;
 }
@@ -4,49 +4,58 @@ namespace model {
 
 Game::Game() {}
 
-Game::Game(int myId, std::vector<model::Player> players, int currentTick, std::vector<model::Unit> units, std::vector<model::Loot> loot, std::vector<model::Projectile> projectiles, model::Zone zone, std::vector<model::Sound> sounds) : myId(myId), players(players), currentTick(currentTick), units(units), loot(loot), projectiles(projectiles), zone(zone), sounds(sounds) { }
+Game::Game(int myId, std::pmr::vector<model::Player> players, int currentTick, std::pmr::vector<model::Unit> units, std::pmr::vector<model::Loot> loot, std::pmr::vector<model::Projectile> projectiles, model::Zone zone, std::pmr::vector<model::Sound> sounds) : myId(myId), players(std::move(players)), currentTick(currentTick), units(std::move(units)), loot(std::move(loot)), projectiles(std::move(projectiles)), zone(zone), sounds(std::move(sounds)) {
+    unitTable.assign(this->units);
+}
+
+Game::Game(const std::pmr::polymorphic_allocator<>& allocator) : players(allocator), units(allocator), loot(allocator), projectiles(allocator), sounds(allocator), unitTable(allocator) { }
 
 // Read Game from input stream
 Game Game::readFrom(InputStream& stream) {
-    int myId = stream.readInt();
-    std::vector<model::Player> players = std::vector<model::Player>();
-    size_t playersSize = stream.readInt();
-    players.reserve(playersSize);
-    for (size_t playersIndex = 0; playersIndex < playersSize; playersIndex++) {
-        model::Player playersElement = model::Player::readFrom(stream);
-        players.emplace_back(playersElement);
+    Game game;
+    Game::readFrom(stream, game);
+    return game;
+}
+
+namespace {
+
+// Reads a list into elements, whose storage and the storage of new elements come from the
+// allocator of the list
+template<typename T>
+void readList(InputStream& stream, std::pmr::vector<T>& elements) {
+    const size_t size = stream.readInt();
+    elements.clear();
+    elements.reserve(size);
+    const std::pmr::polymorphic_allocator<> allocator = elements.get_allocator();
+    for (size_t index = 0; index < size; index++) {
+        if constexpr (requires { T::readFrom(stream, allocator); }) {
+            elements.emplace_back(T::readFrom(stream, allocator));
+        } else {
+            elements.emplace_back(T::readFrom(stream));
+        }
     }
-    int currentTick = stream.readInt();
-    std::vector<model::Unit> units = std::vector<model::Unit>();
-    size_t unitsSize = stream.readInt();
-    units.reserve(unitsSize);
+}
+
+}
+
+// Read Game from input stream into an existing one, its lists are allocated by their allocators
+void Game::readFrom(InputStream& stream, Game& game) {
+    game.myId = stream.readInt();
+    readList(stream, game.players);
+    game.currentTick = stream.readInt();
+    // the hot fields of every unit go to the table right after it's decoded, while it's in cache,
+    // rather than in a second pass over all units
+    const size_t unitsSize = stream.readInt();
+    game.units.clear();
+    game.units.reserve(unitsSize);
+    game.unitTable.clear(unitsSize);
     for (size_t unitsIndex = 0; unitsIndex < unitsSize; unitsIndex++) {
-        model::Unit unitsElement = model::Unit::readFrom(stream);
-        units.emplace_back(unitsElement);
-    }
-    std::vector<model::Loot> loot = std::vector<model::Loot>();
-    size_t lootSize = stream.readInt();
-    loot.reserve(lootSize);
-    for (size_t lootIndex = 0; lootIndex < lootSize; lootIndex++) {
-        model::Loot lootElement = model::Loot::readFrom(stream);
-        loot.emplace_back(lootElement);
-    }
-    std::vector<model::Projectile> projectiles = std::vector<model::Projectile>();
-    size_t projectilesSize = stream.readInt();
-    projectiles.reserve(projectilesSize);
-    for (size_t projectilesIndex = 0; projectilesIndex < projectilesSize; projectilesIndex++) {
-        model::Projectile projectilesElement = model::Projectile::readFrom(stream);
-        projectiles.emplace_back(projectilesElement);
-    }
-    model::Zone zone = model::Zone::readFrom(stream);
-    std::vector<model::Sound> sounds = std::vector<model::Sound>();
-    size_t soundsSize = stream.readInt();
-    sounds.reserve(soundsSize);
-    for (size_t soundsIndex = 0; soundsIndex < soundsSize; soundsIndex++) {
-        model::Sound soundsElement = model::Sound::readFrom(stream);
-        sounds.emplace_back(soundsElement);
+        game.unitTable.append(game.units.emplace_back(model::Unit::readFrom(stream)));
     }
-    return Game(myId, players, currentTick, units, loot, projectiles, zone, sounds);
+    readList(stream, game.loot);
+    readList(stream, game.projectiles);
+    game.zone = model::Zone::readFrom(stream);
+    readList(stream, game.sounds);
 }
 
 // Write Game to output stream
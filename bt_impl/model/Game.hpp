@@ -9,9 +9,11 @@
 #include "model/Projectile.hpp"
 #include "model/Sound.hpp"
 #include "model/Unit.hpp"
+#include "model/UnitTable.hpp"
 #include "model/Vec2.hpp"
 #include "model/Zone.hpp"
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
@@ -19,7 +21,14 @@
 #include <vector>
 #include <unordered_map>
 
-using EnemyMap = std::unordered_map<int, std::reference_wrapper<model::Unit>>;
+// Enemy unit of the game of lastSeenTick, whose memory may be reused once that game is gone
+struct SeenEnemy
+{
+    std::reference_wrapper<model::Unit> unit;
+    int lastSeenTick;
+};
+
+using EnemyMap = std::unordered_map<int, SeenEnemy>;
 
 namespace model {
 
@@ -30,29 +39,33 @@ public:
     // Your player's id
     int myId;
     // List of players (teams)
-    std::vector<model::Player> players;
+    std::pmr::vector<model::Player> players;
     // Current tick
     int currentTick;
     // List of units visible by your team
-    std::vector<model::Unit> units;
+    std::pmr::vector<model::Unit> units;
     // List of loot visible by your team
-    std::vector<model::Loot> loot;
+    std::pmr::vector<model::Loot> loot;
     // List of projectiles visible by your team
-    std::vector<model::Projectile> projectiles;
+    std::pmr::vector<model::Projectile> projectiles;
     // Current state of game zone
     model::Zone zone;
     // List of sounds heard by your team during last tick
-    std::vector<model::Sound> sounds;
+    std::pmr::vector<model::Sound> sounds;
+    // Hot fields of units, kept in sync with them by the constructors and the decoder
+    model::UnitTable unitTable;
 
     Game();
+    // Game with all its lists, and the lists of their elements, allocated by allocator
+    explicit Game(const std::pmr::polymorphic_allocator<> &allocator);
     Game(int myId,
-         std::vector<model::Player> players,
+         std::pmr::vector<model::Player> players,
          int currentTick,
-         std::vector<model::Unit> units,
-         std::vector<model::Loot> loot,
-         std::vector<model::Projectile> projectiles,
+         std::pmr::vector<model::Unit> units,
+         std::pmr::vector<model::Loot> loot,
+         std::pmr::vector<model::Projectile> projectiles,
          model::Zone zone,
-         std::vector<model::Sound> sounds);
+         std::pmr::vector<model::Sound> sounds);
 
     Game(Game &&) = default;
     Game(const Game &) = delete;
@@ -62,6 +75,8 @@ public:
 
     // Read Game from input stream
     static Game readFrom(InputStream &stream);
+    // Read Game from input stream into an existing one, its lists are allocated by their allocators
+    static void readFrom(InputStream &stream, Game &game);
 
     // Write Game to output stream
     void writeTo(OutputStream &stream) const;
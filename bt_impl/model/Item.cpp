@@ -92,15 +92,15 @@ bool Item::Ammo::operator ==(const Item::Ammo& other) const {
     return weaponTypeIndex == other.weaponTypeIndex && amount == other.amount;
 }
 
-// Read Item from input stream
-std::shared_ptr<Item> Item::readFrom(InputStream& stream) {
+// Read Item from input stream, allocating it with allocator
+std::shared_ptr<Item> Item::readFrom(InputStream& stream, const std::pmr::polymorphic_allocator<>& allocator) {
     switch (stream.readInt()) {
     case 0:
-        return std::shared_ptr<Item::Weapon>(new Item::Weapon(Item::Weapon::readFrom(stream)));
+        return std::allocate_shared<Item::Weapon>(allocator, Item::Weapon::readFrom(stream));
     case 1:
-        return std::shared_ptr<Item::ShieldPotions>(new Item::ShieldPotions(Item::ShieldPotions::readFrom(stream)));
+        return std::allocate_shared<Item::ShieldPotions>(allocator, Item::ShieldPotions::readFrom(stream));
     case 2:
-        return std::shared_ptr<Item::Ammo>(new Item::Ammo(Item::Ammo::readFrom(stream)));
+        return std::allocate_shared<Item::Ammo>(allocator, Item::Ammo::readFrom(stream));
     default:
         throw std::runtime_error("Unexpected tag value");
     }
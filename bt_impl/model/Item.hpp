@@ -3,6 +3,7 @@
 
 #include "Stream.hpp"
 #include <memory>
+#include <memory_resource>
 #include <sstream>
 #include <string>
 
@@ -18,8 +19,8 @@ public:
     // Ammo
     class Ammo;
 
-    // Read Item from input stream
-    static std::shared_ptr<Item> readFrom(InputStream& stream);
+    // Read Item from input stream, allocating it with allocator
+    static std::shared_ptr<Item> readFrom(InputStream& stream, const std::pmr::polymorphic_allocator<>& allocator = {});
 
     // Write Item to output stream
     virtual void writeTo(OutputStream& stream) const = 0;
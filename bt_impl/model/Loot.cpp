@@ -4,11 +4,11 @@ namespace model {
 
 Loot::Loot(int id, model::Vec2 position, std::shared_ptr<model::Item> item) : id(id), position(position), item(item) { }
 
-// Read Loot from input stream
-Loot Loot::readFrom(InputStream& stream) {
+// Read Loot from input stream, allocating its item with allocator
+Loot Loot::readFrom(InputStream& stream, const std::pmr::polymorphic_allocator<>& allocator) {
     int id = stream.readInt();
     model::Vec2 position = model::Vec2::readFrom(stream);
-    std::shared_ptr<model::Item> item = model::Item::readFrom(stream);
+    std::shared_ptr<model::Item> item = model::Item::readFrom(stream, allocator);
     return Loot(id, position, item);
 }
 
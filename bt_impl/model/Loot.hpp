@@ -5,6 +5,7 @@
 #include "model/Item.hpp"
 #include "model/Vec2.hpp"
 #include <memory>
+#include <memory_resource>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -23,8 +24,8 @@ public:
 
     Loot(int id, model::Vec2 position, std::shared_ptr<model::Item> item);
 
-    // Read Loot from input stream
-    static Loot readFrom(InputStream& stream);
+    // Read Loot from input stream, allocating its item with allocator
+    static Loot readFrom(InputStream& stream, const std::pmr::polymorphic_allocator<>& allocator = {});
 
     // Write Loot to output stream
     void writeTo(OutputStream& stream) const;
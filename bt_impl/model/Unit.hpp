@@ -5,6 +5,8 @@
 #include "model/Action.hpp"
 #include "model/ActionType.hpp"
 #include "model/Vec2.hpp"
+#include "utils/InlineVector.h"
+#include <cstddef>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
@@ -16,6 +18,9 @@ namespace model {
 // A unit
 class Unit {
 public:
+    // Most weapon types a unit can hold ammo for
+    static constexpr size_t MAX_WEAPONS = 8;
+
     // Unique id
     int id;
     // Id of the player (team) controlling the unit
@@ -45,12 +50,12 @@ public:
     // Next tick when unit can shoot again (can be less than current game tick)
     int nextShotTick;
     // List of ammo in unit's inventory for every weapon type
-    std::vector<int> ammo;
+    InlineVector<int, MAX_WEAPONS> ammo;
     // Number of shield potions in inventory
     int shieldPotions;
 
     Unit() = default;
-    Unit(int id, int playerId, double health, double shield, int extraLives, model::Vec2 position, std::optional<double> remainingSpawnTime, model::Vec2 velocity, model::Vec2 direction, double aim, std::optional<model::Action> action, int healthRegenerationStartTick, std::optional<int> weapon, int nextShotTick, std::vector<int> ammo, int shieldPotions);
+    Unit(int id, int playerId, double health, double shield, int extraLives, model::Vec2 position, std::optional<double> remainingSpawnTime, model::Vec2 velocity, model::Vec2 direction, double aim, std::optional<model::Action> action, int healthRegenerationStartTick, std::optional<int> weapon, int nextShotTick, InlineVector<int, MAX_WEAPONS> ammo, int shieldPotions);
 
     // Read Unit from input stream
     static Unit readFrom(InputStream& stream);
@@ -0,0 +1,48 @@
+#include "UnitTable.hpp"
+
+namespace model {
+
+UnitTable::UnitTable(const std::pmr::polymorphic_allocator<> &allocator)
+    : id(allocator), playerId(allocator), position(allocator), velocity(allocator),
+      direction(allocator), health(allocator), shield(allocator), weapon(allocator),
+      spawned(allocator)
+{}
+
+void UnitTable::assign(const std::pmr::vector<model::Unit> &units)
+{
+    clear(units.size());
+    for (const auto &unit : units)
+        append(unit);
+}
+
+void UnitTable::clear(size_t size)
+{
+    const auto clear = [size](auto &field) {
+        field.clear();
+        field.reserve(size);
+    };
+    clear(id);
+    clear(playerId);
+    clear(position);
+    clear(velocity);
+    clear(direction);
+    clear(health);
+    clear(shield);
+    clear(weapon);
+    clear(spawned);
+}
+
+void UnitTable::append(const model::Unit &unit)
+{
+    id.push_back(unit.id);
+    playerId.push_back(unit.playerId);
+    position.push_back(unit.position);
+    velocity.push_back(unit.velocity);
+    direction.push_back(unit.direction);
+    health.push_back(unit.health);
+    shield.push_back(unit.shield);
+    weapon.push_back(unit.weapon.value_or(-1));
+    spawned.push_back(!unit.remainingSpawnTime);
+}
+
+} // namespace model
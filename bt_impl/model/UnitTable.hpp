@@ -0,0 +1,41 @@
+#pragma once
+
+#include "model/Unit.hpp"
+#include "model/Vec2.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace model {
+
+// Fields of units read by scans over all of them, one array per field in the order of the units,
+// so a scan only loads the fields it reads
+class UnitTable
+{
+public:
+    std::pmr::vector<int> id;
+    std::pmr::vector<int> playerId;
+    std::pmr::vector<model::Vec2> position;
+    std::pmr::vector<model::Vec2> velocity;
+    std::pmr::vector<model::Vec2> direction;
+    std::pmr::vector<double> health;
+    std::pmr::vector<double> shield;
+    // Index of the weapon the unit is holding, or -1
+    std::pmr::vector<int> weapon;
+    // Whether the unit is on the map, rather than waiting to spawn
+    std::pmr::vector<std::uint8_t> spawned;
+
+    explicit UnitTable(const std::pmr::polymorphic_allocator<> &allocator = {});
+
+    size_t size() const { return id.size(); }
+
+    // Replace the table with the fields of units
+    void assign(const std::pmr::vector<model::Unit> &units);
+    // Remove all units, keeping the storage for at least size of them
+    void clear(size_t size);
+    // Append the fields of unit
+    void append(const model::Unit &unit);
+};
+
+} // namespace model
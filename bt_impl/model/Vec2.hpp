@@ -4,6 +4,7 @@
 #include <sstream>
 #include <string>
 #include <cmath>
+#include <utility>
 
 namespace model {
 
@@ -29,18 +30,21 @@ public:
 
     inline auto length() const noexcept { return std::sqrt(sqrLength()); }
 
+    // A zero vector stays zero
     inline auto &normalize() noexcept
     {
-        const auto len = length();
-        x /= len;
-        y /= len;
+        if (const auto len = length(); len > 0) {
+            x /= len;
+            y /= len;
+        }
         return *this;
     }
 
+    // A zero vector stays zero
     inline auto normalize() const noexcept
     {
-        const auto len = length();
-        return Vec2{x / len, y / len};
+        auto result = *this;
+        return result.normalize();
     }
 
     // Read Vec2 from input stream
@@ -68,6 +72,11 @@ inline auto operator-(const Vec2 &v1, const Vec2 &v2)
     return Vec2{v1.x - v2.x, v1.y - v2.y};
 }
 
+inline auto operator+(const Vec2 &v1, const Vec2 &v2)
+{
+    return Vec2{v1.x + v2.x, v1.y + v2.y};
+}
+
 inline auto operator+=(Vec2 &v1, const Vec2 &v2)
 {
     v1.x += v2.x;
@@ -75,40 +84,38 @@ inline auto operator+=(Vec2 &v1, const Vec2 &v2)
     return v1;
 }
 
+inline auto dotProduct(const Vec2 &vec1, const Vec2 &vec2)
+{
+    return vec1.x * vec2.x + vec1.y * vec2.y;
+}
+
+// Projection of point onto the line through rayPos along rayDir, rayPos for a zero rayDir
 inline auto rayPointOrthogonalIntersect(Vec2 rayPos, Vec2 rayDir, Vec2 point)
 {
-    if (realNearlyEqual(rayDir.x, 0.0))
-        return Vec2{rayPos.x, point.y};
-
-    const auto m1 = rayDir.y / rayDir.x;
-    const auto c1 = rayPos.y - m1 * rayPos.x;
-    const auto m2 = -1 / m1;
-    const auto c2 = point.y - m2 * point.x;
-    const auto x = (c2 - c1) / (m1 - m2);
-    return Vec2{x, m1 * x + c1};
+    const auto sqrLength = rayDir.sqrLength();
+    if (sqrLength <= 0)
+        return rayPos;
+
+    return rayPos + rayDir * (dotProduct(point - rayPos, rayDir) / sqrLength);
 }
 
+// Whether the line through rayPos along rayDir passes closer than radius to center, and the
+// normal from the line towards center, any normal of the line if center lies on it
 inline auto rayCircleIntersectNormalVector(Vec2 rayPos, Vec2 rayDir, Vec2 center, double radius)
 {
     const auto intersect = rayPointOrthogonalIntersect(rayPos, rayDir, center);
     if (center == intersect) {
-        constexpr auto anyX = 1;
-        // calculate orthogonal vector using dot product
-        return std::pair{true, Vec2{anyX, -(anyX + intersect.x) / intersect.y}};
+        return std::pair{true, Vec2{-rayDir.y, rayDir.x}};
     } else {
         const auto normal = center - intersect;
         return std::pair{normal.sqrLength() < radius * radius, normal};
     }
 }
 
+// Velocity of length maxSpeed along vec, zero for a zero vec
 inline auto normalizeVelocity(const Vec2 &vec, double maxSpeed)
 {
     return vec.normalize() * maxSpeed;
 }
 
-inline auto dotProduct(const Vec2 &vec1, const Vec2 &vec2)
-{
-    return vec1.x * vec2.x + vec1.y * vec2.y;
-}
-
 } // namespace model
@@ -0,0 +1,474 @@
+#!/usr/bin/env python3
+"""Compiles behavior tree XML files into C++ classes.
+
+Every file becomes a class in namespace `compiled` named after the file (main_behavior.xml ->
+MainBehavior) with `tick()` and `halt()` methods. Node statuses, sequence indices and parallel
+skip lists are plain members, blackboard entries are typed `std::optional` members and port
+literals are parsed here, so a tick is a chain of direct calls into `Actions`.
+
+Control and decorator nodes reproduce BehaviorTree.CPP 3.7 semantics, including the statuses
+kept by children between ticks. Unknown nodes are an error, so a tree can't silently compile
+into something the interpreter would execute differently.
+"""
+
+import argparse
+import pathlib
+import re
+import sys
+import xml.etree.ElementTree as ElementTree
+
+HEADER_NAME = "CompiledBehaviors.h"
+SOURCE_NAME = "CompiledBehaviors.cpp"
+
+
+class Leaf:
+    def __init__(self, ports, body, stateful=False):
+        # port name -> (C++ type, is output)
+        self.ports = ports
+        self.body = body
+        self.stateful = stateful
+
+
+# Must mirror MyStrategy::registerNodes and the node classes in behavior_nodes/.
+LEAVES = {
+    "Move": Leaf({"vector": ("model::Vec2", False)}, "return m_actions.move({vector});"),
+    "Dodge": Leaf({}, "return m_actions.dodge();"),
+    "AvoidZone": Leaf({}, "return m_actions.avoidZone();"),
+    "Shoot": Leaf({"id": ("int", False)}, "return m_actions.shoot();"),
+    "GoCenter": Leaf({}, "return m_actions.goCenter();"),
+    "GetClosestTarget": Leaf(
+        {"id": ("int", True)},
+        """const auto target = m_actions.closestTarget();
+        if (!target)
+            return BT::NodeStatus::FAILURE;
+        {id} = target.value();
+        return BT::NodeStatus::SUCCESS;""",
+    ),
+    "RankTargets": Leaf(
+        {"id": ("int", True)},
+        """const auto &ranked = m_actions.rankedTargets();
+        if (ranked.empty())
+            return BT::NodeStatus::FAILURE;
+        {id} = ranked.front();
+        return BT::NodeStatus::SUCCESS;""",
+    ),
+    "Look": Leaf(
+        {"vector": ("model::Vec2", False), "id": ("int", False)},
+        "return m_actions.look({vector}, {id});",
+        stateful=True,
+    ),
+    "GoToTarget": Leaf({"id": ("int", False)}, "return m_actions.goToTarget({id});", stateful=True),
+}
+
+CONTROLS = {"Sequence", "Fallback", "ReactiveSequence", "ReactiveFallback", "Parallel"}
+DECORATORS = {"ForceSuccess", "ForceFailure", "SubTree", "SubTreePlus"}
+IGNORED_ATTRIBUTES = {"name", "ID", "__shared_blackboard", "__autoremap"}
+
+
+class CompileError(Exception):
+    pass
+
+
+def class_name(path):
+    return "".join(part.capitalize() for part in re.split(r"[^0-9a-zA-Z]+", path.stem) if part)
+
+
+def literal(cpp_type, text):
+    if cpp_type == "model::Vec2":
+        parts = text.split(",")
+        if len(parts) != 2:
+            raise CompileError(f"invalid Vec2 literal '{text}'")
+        # parsed as float by BT::convertFromString<Vec2>, keep the same rounding
+        return "model::Vec2{{{}f, {}f}}".format(*(repr(float(part)) for part in parts))
+    if cpp_type == "int":
+        return str(int(text))
+    raise CompileError(f"literals of type {cpp_type} are not supported")
+
+
+class Node:
+    def __init__(self, index, kind, element):
+        self.index = index
+        self.kind = kind
+        self.element = element
+        self.children = []
+        self.ports = {}
+
+
+class TreeCompiler:
+    def __init__(self, path):
+        self.path = path
+        self.prefix = class_name(path).upper()
+        self.root = ElementTree.parse(path).getroot()
+        self.trees = {tree.get("ID"): tree for tree in self.root.findall("BehaviorTree")}
+        self.nodes = []
+        self.fields = {}  # member name -> C++ type
+        self.literals = []  # (name, C++ type, expression)
+        self.scopes = 0
+
+    def compile(self):
+        main = self.root.get("main_tree_to_execute") or next(iter(self.trees))
+        return self.tree(main, {})
+
+    def tree(self, tree_id, remapping):
+        if tree_id not in self.trees:
+            raise CompileError(f"unknown tree '{tree_id}'")
+        children = list(self.trees[tree_id])
+        if len(children) != 1:
+            raise CompileError(f"tree '{tree_id}' must have exactly one root node")
+
+        scope = f"{re.sub(r'[^0-9a-zA-Z]', '_', tree_id).lower()}{self.scopes}"
+        self.scopes += 1
+        return self.node(children[0], scope, remapping)
+
+    def blackboard(self, key, cpp_type, scope, remapping):
+        if key in remapping:
+            field = remapping[key]
+        else:
+            field = f"m_{scope}_{key}"
+            remapping[key] = field
+
+        known = self.fields.setdefault(field, cpp_type)
+        if known != cpp_type:
+            raise CompileError(f"blackboard entry '{key}' used as {known} and {cpp_type}")
+        return field
+
+    def node(self, element, scope, remapping):
+        node = Node(len(self.nodes), element.tag, element)
+        self.nodes.append(node)
+
+        if element.tag in LEAVES:
+            leaf = LEAVES[element.tag]
+            for attribute in element.attrib:
+                if attribute not in leaf.ports and attribute not in IGNORED_ATTRIBUTES:
+                    raise CompileError(f"{element.tag} has no port '{attribute}'")
+            for port, (cpp_type, output) in leaf.ports.items():
+                node.ports[port] = self.port(node, port, cpp_type, output, scope, remapping)
+        elif element.tag in CONTROLS:
+            node.children = [self.node(child, scope, remapping) for child in element]
+            if not node.children:
+                raise CompileError(f"{element.tag} has no children")
+        elif element.tag in {"ForceSuccess", "ForceFailure"}:
+            node.children = [self.node(child, scope, remapping) for child in element]
+            if len(node.children) != 1:
+                raise CompileError(f"{element.tag} must have exactly one child")
+        elif element.tag in {"SubTree", "SubTreePlus"}:
+            node.children = [self.tree(element.get("ID"), self.subtree_remapping(element, remapping))]
+        else:
+            raise CompileError(f"unsupported node '{element.tag}'")
+        return node
+
+    def subtree_remapping(self, element, remapping):
+        if element.get("__shared_blackboard") == "true":
+            return remapping
+
+        child = {}
+        if element.get("__autoremap") == "true":
+            child.update(remapping)
+        for attribute, value in element.attrib.items():
+            if attribute in IGNORED_ATTRIBUTES:
+                continue
+            match = re.fullmatch(r"\{(\w+)\}", value)
+            if not match:
+                raise CompileError(f"subtree remapping '{attribute}={value}' must be a blackboard key")
+            if match.group(1) not in remapping:
+                raise CompileError(f"subtree remaps unknown blackboard entry '{value}'")
+            child[attribute] = remapping[match.group(1)]
+        return child
+
+    def port(self, node, port, cpp_type, output, scope, remapping):
+        value = node.element.get(port)
+        match = re.fullmatch(r"\{(\w+)\}", value) if value is not None else None
+        if match:
+            return self.blackboard(match.group(1), cpp_type, scope, remapping)
+        if output:
+            if value is not None:
+                raise CompileError(f"output port '{port}' of {node.kind} must be a blackboard key")
+            return self.blackboard(f"unused_{node.index}_{port}", cpp_type, scope, {})
+        if value is None:
+            return f"std::optional<{cpp_type}>{{}}"
+
+        name = f"{self.prefix}_LITERAL_{len(self.literals)}"
+        self.literals.append((name, cpp_type, literal(cpp_type, value)))
+        return name
+
+
+class Emitter:
+    def __init__(self, name, compiler):
+        self.name = name
+        self.compiler = compiler
+        self.nodes = compiler.nodes
+
+    def declaration(self):
+        lines = [f"class {self.name}", "{", "public:"]
+        lines += [f"    explicit {self.name}(Actions &actions);", ""]
+        lines += ["    BT::NodeStatus tick();", "    void halt();", "", "private:"]
+        for node in self.nodes:
+            lines.append(f"    BT::NodeStatus tick{node.index}();")
+            lines.append(f"    void halt{node.index}();")
+            lines.append(f"    void reset{node.index}();")
+        lines += ["", "private:", "    Actions &m_actions;"]
+        lines.append(f"    std::array<BT::NodeStatus, {len(self.nodes)}> m_status{{}};")
+        for node in self.nodes:
+            if node.kind in {"Sequence", "Fallback"}:
+                lines.append(f"    size_t m_childIndex{node.index} = 0;")
+            elif node.kind == "Parallel":
+                lines.append(f"    std::array<bool, {len(node.children)}> m_skip{node.index}{{}};")
+        for field, cpp_type in self.compiler.fields.items():
+            lines.append(f"    std::optional<{cpp_type}> {field};")
+        lines.append("};")
+        return "\n".join(lines)
+
+    def definition(self):
+        cls = self.name
+        out = [f"{cls}::{cls}(Actions &actions) : m_actions{{actions}} {{}}", ""]
+        out += [
+            f"BT::NodeStatus {cls}::tick()",
+            "{",
+            "    const auto status = tick0();",
+            "    if (status == BT::NodeStatus::SUCCESS || status == BT::NodeStatus::FAILURE)",
+            "        m_status[0] = BT::NodeStatus::IDLE;",
+            "    return status;",
+            "}",
+            "",
+            f"void {cls}::halt()",
+            "{",
+            "    reset0();",
+            "}",
+            "",
+        ]
+        for node in self.nodes:
+            out += self.tick(node) + [""]
+            out += self.halt(node) + [""]
+            out += [
+                f"void {cls}::reset{node.index}()",
+                "{",
+                f"    if (m_status[{node.index}] == BT::NodeStatus::RUNNING)",
+                f"        halt{node.index}();",
+                f"    m_status[{node.index}] = BT::NodeStatus::IDLE;",
+                "}",
+                "",
+            ]
+        return "\n".join(out)
+
+    def tick(self, node):
+        i = node.index
+        body = getattr(self, "tick_" + node.kind, None)
+        lines = [f"BT::NodeStatus {self.name}::tick{i}()", "{"]
+        if body is None:
+            lines += self.tick_leaf(node)
+        else:
+            lines += [f"    const auto status = [&] {{"]
+            lines += ["    " + line for line in body(node)]
+            lines += ["    }();", f"    m_status[{i}] = status;", "    return status;"]
+        lines.append("}")
+        return lines
+
+    def tick_leaf(self, node):
+        leaf = LEAVES[node.kind]
+        body = leaf.body.format(**node.ports)
+        i = node.index
+        if leaf.stateful:
+            # StatefulActionNode keeps returning its SUCCESS/FAILURE until its parent resets it
+            return [
+                f"    if (m_status[{i}] == BT::NodeStatus::SUCCESS || m_status[{i}] == BT::NodeStatus::FAILURE)",
+                f"        return m_status[{i}];",
+                "",
+                "    const auto status = [&] {",
+                f"        {body}",
+                "    }();",
+                f"    m_status[{i}] = status;",
+                "    return status;",
+            ]
+        return [
+            "    const auto status = [&] {",
+            f"        {body}",
+            "    }();",
+            f"    m_status[{i}] = status;",
+            "    return status;",
+        ]
+
+    def reset_children(self, node, first=0, indent=4):
+        return [" " * indent + f"reset{child.index}();" for child in node.children[first:]]
+
+    def halt(self, node):
+        i = node.index
+        lines = [f"void {self.name}::halt{i}()", "{"]
+        if node.kind in {"Sequence", "Fallback"}:
+            lines.append(f"    m_childIndex{i} = 0;")
+        elif node.kind == "Parallel":
+            lines.append(f"    m_skip{i}.fill(false);")
+        lines += self.reset_children(node)
+        lines.append("}")
+        return lines
+
+    def sequence(self, node, keep_going, stop):
+        i = node.index
+        lines = [f"    switch (m_childIndex{i}) {{"]
+        for position, child in enumerate(node.children):
+            lines += [
+                f"    case {position}:",
+                "    {",
+                f"        const auto childStatus = tick{child.index}();",
+                "        if (childStatus == BT::NodeStatus::RUNNING)",
+                "            return childStatus;",
+                f"        if (childStatus == BT::NodeStatus::{stop}) {{",
+            ]
+            lines += self.reset_children(node, indent=12)
+            lines += [
+                f"            m_childIndex{i} = 0;",
+                "            return childStatus;",
+                "        }",
+                f"        ++m_childIndex{i};",
+                "    }",
+                "        [[fallthrough]];",
+            ]
+        lines += ["    default:", "        break;", "    }"]
+        lines += self.reset_children(node)
+        lines += [f"    m_childIndex{i} = 0;", f"    return BT::NodeStatus::{keep_going};"]
+        return lines
+
+    def tick_Sequence(self, node):
+        return self.sequence(node, "SUCCESS", "FAILURE")
+
+    def tick_Fallback(self, node):
+        return self.sequence(node, "FAILURE", "SUCCESS")
+
+    def reactive(self, node, keep_going, stop):
+        lines = []
+        for position, child in enumerate(node.children):
+            lines += [
+                "    {",
+                f"        const auto childStatus = tick{child.index}();",
+                "        if (childStatus == BT::NodeStatus::RUNNING) {",
+            ]
+            lines += self.reset_children(node, position + 1, indent=12)
+            lines += [
+                "            return childStatus;",
+                "        }",
+                f"        if (childStatus == BT::NodeStatus::{stop}) {{",
+            ]
+            lines += self.reset_children(node, indent=12)
+            lines += ["            return childStatus;", "        }", "    }"]
+        lines += self.reset_children(node)
+        lines.append(f"    return BT::NodeStatus::{keep_going};")
+        return lines
+
+    def tick_ReactiveSequence(self, node):
+        return self.reactive(node, "SUCCESS", "FAILURE")
+
+    def tick_ReactiveFallback(self, node):
+        return self.reactive(node, "FAILURE", "SUCCESS")
+
+    def tick_Parallel(self, node):
+        i = node.index
+        success_threshold = int(node.element.get("success_threshold", len(node.children)))
+        failure_threshold = int(node.element.get("failure_threshold", 1))
+        if len(node.children) < success_threshold:
+            raise CompileError("Parallel has fewer children than its success threshold")
+
+        lines = ["    auto successes = 0;", "    auto failures = 0;"]
+        for position, child in enumerate(node.children):
+            lines += [
+                "    {",
+                f"        const auto skipped = m_skip{i}[{position}];",
+                f"        const auto childStatus = skipped ? m_status[{child.index}] : tick{child.index}();",
+                "        if (childStatus == BT::NodeStatus::SUCCESS || childStatus == BT::NodeStatus::FAILURE)",
+                f"            m_skip{i}[{position}] = true;",
+                "        if (childStatus == BT::NodeStatus::SUCCESS",
+                f"            && ++successes == {success_threshold}) {{",
+                f"            m_skip{i}.fill(false);",
+            ]
+            lines += self.reset_children(node, indent=12)
+            lines += [
+                "            return BT::NodeStatus::SUCCESS;",
+                "        }",
+                "        if (childStatus == BT::NodeStatus::FAILURE",
+                f"            && (++failures == {failure_threshold}",
+                f"                || {len(node.children)} - failures < {success_threshold})) {{",
+                f"            m_skip{i}.fill(false);",
+            ]
+            lines += self.reset_children(node, indent=12)
+            lines += ["            return BT::NodeStatus::FAILURE;", "        }", "    }"]
+        lines.append("    return BT::NodeStatus::RUNNING;")
+        return lines
+
+    def tick_ForceSuccess(self, node):
+        return self.force(node, "SUCCESS")
+
+    def tick_ForceFailure(self, node):
+        return self.force(node, "FAILURE")
+
+    def force(self, node, result):
+        child = node.children[0]
+        return [
+            f"    const auto childStatus = tick{child.index}();",
+            "    return childStatus == BT::NodeStatus::RUNNING ? childStatus",
+            f"                                                : BT::NodeStatus::{result};",
+        ]
+
+    def tick_SubTree(self, node):
+        return [f"    return tick{node.children[0].index}();"]
+
+    def tick_SubTreePlus(self, node):
+        return self.tick_SubTree(node)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--output", required=True, type=pathlib.Path)
+    parser.add_argument("behaviors", nargs="+", type=pathlib.Path)
+    arguments = parser.parse_args()
+
+    classes = []
+    for path in sorted(arguments.behaviors):
+        compiler = TreeCompiler(path)
+        try:
+            compiler.compile()
+        except CompileError as error:
+            sys.exit(f"{path}: {error}")
+        classes.append((path, class_name(path), compiler))
+
+    header = [
+        "// Generated by tools/compile_behaviors.py, do not edit.",
+        "",
+        "#pragma once",
+        "",
+        "#include <array>",
+        "#include <optional>",
+        "#include <vector>",
+        "",
+        '#include "behavior_nodes/Actions.h"',
+        "",
+        "namespace compiled {",
+        "",
+    ]
+    source = [
+        "// Generated by tools/compile_behaviors.py, do not edit.",
+        "",
+        f'#include "{HEADER_NAME}"',
+        "",
+        "namespace compiled {",
+        "",
+    ]
+    for path, name, compiler in classes:
+        emitter = Emitter(name, compiler)
+        header += [f"// {path.name}", emitter.declaration(), ""]
+        if compiler.literals:
+            source += ["namespace {", ""]
+            for literal_name, cpp_type, expression in compiler.literals:
+                source.append(f"const auto {literal_name} = std::optional<{cpp_type}>{{{expression}}};")
+            source += ["", "} // namespace", ""]
+        source += [emitter.definition()]
+    header += ["} // namespace compiled", ""]
+    source += ["} // namespace compiled", ""]
+
+    arguments.output.mkdir(parents=True, exist_ok=True)
+    for file_name, lines in ((HEADER_NAME, header), (SOURCE_NAME, source)):
+        target = arguments.output / file_name
+        content = "\n".join(lines)
+        if not target.exists() or target.read_text() != content:
+            target.write_text(content)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,118 @@
+#include "TreeReloader.h"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace BT;
+
+constexpr auto POLL_TIMEOUT = 200; // ms, how long stopping may take
+constexpr auto SETTLE_TIMEOUT = 50; // ms, editors write a file in several steps
+
+TreeReloader::Subscription::Subscription(TreeReloader &reloader, Builder builder)
+    : m_reloader{reloader}, m_builder{move(builder)}
+{}
+
+TreeReloader::Subscription::~Subscription()
+{
+    {
+        lock_guard lock{m_reloader.m_mutex};
+        erase(m_reloader.m_subscriptions, this);
+    }
+    delete m_pending.exchange(nullptr);
+}
+
+unique_ptr<Tree> TreeReloader::Subscription::takeTree()
+{
+    if (!m_pending.load(memory_order_relaxed))
+        return nullptr;
+    return unique_ptr<Tree>{m_pending.exchange(nullptr, memory_order_acquire)};
+}
+
+TreeReloader::TreeReloader(string directory, string fileName)
+    : m_directory{move(directory)}, m_fileName{move(fileName)}
+{
+#ifdef __linux__
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotify < 0
+        || inotify_add_watch(m_inotify, m_directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        cout << "Couldn't watch " << m_directory << ": " << strerror(errno) << endl;
+        return;
+    }
+    m_thread = thread{&TreeReloader::run, this};
+#endif
+}
+
+TreeReloader::~TreeReloader()
+{
+    m_stopped = true;
+    if (m_thread.joinable())
+        m_thread.join();
+#ifdef __linux__
+    if (m_inotify >= 0)
+        close(m_inotify);
+#endif
+}
+
+unique_ptr<TreeReloader::Subscription> TreeReloader::subscribe(Builder builder)
+{
+    auto subscription = unique_ptr<Subscription>{new Subscription{*this, move(builder)}};
+    lock_guard lock{m_mutex};
+    m_subscriptions.push_back(subscription.get());
+    return subscription;
+}
+
+void TreeReloader::run()
+{
+#ifdef __linux__
+    alignas(inotify_event) array<char, 4096> buffer;
+    pollfd descriptor{m_inotify, POLLIN, 0};
+
+    auto changed = false;
+    while (!m_stopped) {
+        // after a change wait until the directory is quiet before rebuilding
+        const auto ready = poll(&descriptor, 1, changed ? SETTLE_TIMEOUT : POLL_TIMEOUT);
+        if (ready < 0 && errno != EINTR)
+            break;
+
+        if (ready <= 0) {
+            if (changed)
+                rebuild();
+            changed = false;
+            continue;
+        }
+
+        ssize_t length;
+        while ((length = read(m_inotify, buffer.data(), buffer.size())) > 0) {
+            for (auto offset = 0; offset < length;) {
+                const auto *event = reinterpret_cast<const inotify_event *>(buffer.data() + offset);
+                if (event->len && m_fileName == event->name)
+                    changed = true;
+                offset += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+#endif
+}
+
+void TreeReloader::rebuild()
+{
+    lock_guard lock{m_mutex};
+    try {
+        for (auto *subscription : m_subscriptions) {
+            auto tree = make_unique<Tree>(subscription->m_builder(m_directory + m_fileName));
+            delete subscription->m_pending.exchange(tree.release(), memory_order_release);
+        }
+        cout << "Reloaded " << m_fileName << endl;
+    } catch (const exception &e) {
+        cout << "Couldn't reload " << m_fileName << ": " << e.what() << endl;
+    }
+}
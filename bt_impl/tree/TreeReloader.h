@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <behaviortree_cpp_v3/bt_factory.h>
+
+/**
+ * Rebuilds the behavior trees of all subscribers when their XML file changes.
+ *
+ * One background thread watches the directory with inotify and builds the new trees itself, one
+ * per subscriber with its builder. The tick threads only pick up a finished tree with
+ * `Subscription::takeTree()` between ticks, which never blocks. A file that fails to parse is
+ * reported and the current trees are kept. Does nothing on platforms without inotify.
+ */
+class TreeReloader
+{
+public:
+    using Builder = std::function<BT::Tree(const std::string &path)>;
+
+    class Subscription
+    {
+    public:
+        ~Subscription();
+
+        Subscription(const Subscription &) = delete;
+        Subscription &operator=(const Subscription &) = delete;
+
+        /**
+         * @return Tree rebuilt since the last call, or nullptr.
+         */
+        std::unique_ptr<BT::Tree> takeTree();
+
+    private:
+        friend class TreeReloader;
+
+        Subscription(TreeReloader &reloader, Builder builder);
+
+    private:
+        TreeReloader &m_reloader;
+        Builder m_builder;
+        std::atomic<BT::Tree *> m_pending = nullptr;
+    };
+
+    TreeReloader(std::string directory, std::string fileName);
+    ~TreeReloader();
+
+    TreeReloader(const TreeReloader &) = delete;
+    TreeReloader &operator=(const TreeReloader &) = delete;
+
+    /**
+     * @p builder is called on the reloader's thread after every change, until the subscription
+     * is destroyed, which must happen before the reloader is.
+     */
+    std::unique_ptr<Subscription> subscribe(Builder builder);
+
+private:
+    void run();
+    void rebuild();
+
+private:
+    std::string m_directory;
+    std::string m_fileName;
+
+    // held while trees are built, so a subscription isn't destroyed while its builder runs
+    std::mutex m_mutex;
+    std::vector<Subscription *> m_subscriptions;
+
+    std::atomic<bool> m_stopped = false;
+    int m_inotify = -1;
+    std::thread m_thread;
+};
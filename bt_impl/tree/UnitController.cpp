@@ -0,0 +1,208 @@
+#include "UnitController.h"
+
+#include <fstream>
+#include <iostream>
+
+#include "behavior_nodes/GoToTarget.h"
+#include "behavior_nodes/LookAction.h"
+#include "behavior_nodes/MoveAction.h"
+#include "behavior_nodes/RankTargets.h"
+
+using namespace std;
+using namespace BT;
+using namespace model;
+
+constexpr auto TRACE = false; // writes a trace file per unit on finish
+
+namespace {
+
+/**
+ * Copies the values of @p from to the entries of @p to with the same key and type, so a reloaded
+ * tree keeps what the old one remembered.
+ */
+void copyEntries(Blackboard &from, Blackboard &to)
+{
+    for (const auto &key : from.getKeys()) {
+        const string name{key};
+        const auto *source = from.getAny(name);
+        auto *target = to.getAny(name);
+        if (!source || source->empty() || !target)
+            continue;
+
+        const auto *sourceInfo = from.portInfo(name);
+        const auto *targetInfo = to.portInfo(name);
+        const auto *sourceType = sourceInfo ? sourceInfo->type() : nullptr;
+        const auto *targetType = targetInfo ? targetInfo->type() : nullptr;
+        if (sourceType && targetType && *sourceType != *targetType)
+            continue;
+        *target = *source;
+    }
+}
+
+} // namespace
+
+UnitController::UnitController(const DerivedConstants &constants,
+                               const StrategyParameters &parameters,
+                               const Game &game,
+                               const EnemyMap &enemies,
+                               const ZonePredictor &zonePredictor,
+                               const ObstacleIndex &obstacleIndex,
+                               const DangerMap &dangerMap,
+                               string behaviorsPath,
+                               string behaviorFile,
+                               bool logTransitions,
+                               TreeReloader *reloader)
+    : m_behaviorsPath{move(behaviorsPath)},
+      m_behaviorFile{move(behaviorFile)}, m_logTransitions{logTransitions}, m_game{game},
+      m_facts{constants, game, m_unit, enemies},
+      m_localAvoidance{constants, obstacleIndex},
+      m_actions{constants,
+                parameters,
+                game,
+                m_unit,
+                enemies,
+                m_order,
+                m_facts,
+                zonePredictor,
+                obstacleIndex,
+                dangerMap}
+{
+#ifndef COMPILED_BEHAVIORS
+    registerNodes();
+    initTree(reloader);
+#else
+    (void)reloader;
+#endif
+}
+
+optional<UnitOrder> UnitController::tick(const Unit &unit)
+{
+    m_unit = unit;
+    m_facts.invalidate();
+    m_order = {};
+
+#ifdef COMPILED_BEHAVIORS
+    const auto status = m_compiledTree.tick();
+#else
+    if (m_reload) {
+        if (auto tree = m_reload->takeTree())
+            setTree(move(*tree));
+    }
+    if (m_profiler)
+        m_profiler->beginTick();
+    const auto status = m_tree.tickRoot();
+    if (m_profiler)
+        m_profiler->endTick();
+#endif
+    if (status == NodeStatus::FAILURE)
+        return nullopt;
+
+    m_order.targetVelocity = m_localAvoidance.filter(m_game, m_unit, m_order.targetVelocity);
+    return m_order;
+}
+
+void UnitController::finish()
+{
+    if (!m_profiler)
+        return;
+
+    cout << "unit " << m_unit.id << ' ';
+    m_profiler->report(cout);
+    if (TRACE) {
+        ofstream trace{"behavior_trace_" + to_string(m_unit.id) + ".json"};
+        m_profiler->exportChromeTrace(trace);
+    }
+}
+
+void UnitController::registerNodes()
+{
+    const auto lookBuilder = [this](const string &name, const NodeConfiguration &config) {
+        return make_unique<LookAction>(m_actions, name, config);
+    };
+
+    const auto goToTargetBuilder = [this](const string &name, const NodeConfiguration &config) {
+        return make_unique<GoToTarget>(m_actions, name, config);
+    };
+
+    const auto moveBuilder = [this](const string &name, const NodeConfiguration &config) {
+        return make_unique<MoveAction>(m_actions, name, config);
+    };
+
+    const auto rankTargetsBuilder = [this](const string &name, const NodeConfiguration &config) {
+        return make_unique<RankTargets>(m_actions, name, config);
+    };
+
+    // --- ports list
+
+    PortsList idOutPort = {OutputPort<int>("id")};
+    PortsList idInPort = {InputPort<int>("id")};
+
+
+    // ---- action nodes
+
+    m_factory.registerBuilder<LookAction>("Look", lookBuilder);
+    m_factory.registerBuilder<GoToTarget>("GoToTarget", goToTargetBuilder);
+    m_factory.registerBuilder<RankTargets>("RankTargets", rankTargetsBuilder);
+    m_factory.registerBuilder<MoveAction>("Move", moveBuilder);
+
+    m_factory.registerSimpleAction("Dodge", [this](TreeNode &) { return m_actions.dodge(); });
+
+    m_factory.registerSimpleAction("AvoidZone", [this](TreeNode &) { return m_actions.avoidZone(); });
+
+    m_factory.registerSimpleAction(
+        "GetClosestTarget",
+        [this](TreeNode &self) {
+            const auto target = m_actions.closestTarget();
+            if (!target) {
+                return NodeStatus::FAILURE;
+            } else {
+                self.setOutput("id", target.value());
+                return NodeStatus::SUCCESS;
+            }
+        },
+        idOutPort);
+
+    m_factory.registerSimpleAction(
+        "Shoot", [this](TreeNode &) { return m_actions.shoot(); }, idInPort);
+
+    m_factory.registerSimpleAction("GoCenter", [this](TreeNode &) { return m_actions.goCenter(); });
+
+    // ---- condition nodes
+
+    // ---- decorator nodes
+}
+
+void UnitController::initTree(TreeReloader *reloader)
+{
+    try {
+        setTree(m_factory.createTreeFromFile(m_behaviorsPath + m_behaviorFile));
+    } catch (const runtime_error &e) {
+        cout << e.what() << endl;
+    }
+
+    // the tick thread writes the blackboard of the current tree without locking, so a new tree
+    // gets its own, filled in by setTree between ticks
+    if (reloader) {
+        m_reload = reloader->subscribe(
+            [this](const string &path) { return m_factory.createTreeFromFile(path); });
+    }
+}
+
+void UnitController::setTree(Tree &&tree)
+{
+    if (m_tree.rootNode())
+        copyEntries(*m_tree.rootBlackboard(), *tree.rootBlackboard());
+
+    // loggers are subscribed to the nodes of the old tree
+    m_logger.reset();
+    m_profiler.reset();
+
+    if (m_tree.rootNode())
+        m_tree.haltTree();
+    m_tree = move(tree);
+
+    m_profiler = make_unique<TreeProfiler>(m_tree);
+    if (m_logTransitions) {
+        m_logger = make_unique<StdCoutLogger>(m_tree);
+    }
+}
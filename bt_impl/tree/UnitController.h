@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include <behaviortree_cpp_v3/bt_factory.h>
+#include <behaviortree_cpp_v3/loggers/bt_cout_logger.h>
+
+#include "behavior_nodes/Actions.h"
+#include "loggers/TreeProfiler.h"
+#include "model/Game.hpp"
+#include "model/UnitOrder.hpp"
+#include "tree/TreeReloader.h"
+#include "world/DangerMap.h"
+#include "world/DerivedConstants.h"
+#include "world/LocalAvoidance.h"
+#include "world/ObstacleIndex.h"
+#include "world/StrategyParameters.h"
+#include "world/WorldFacts.h"
+#include "world/ZonePredictor.h"
+
+#ifdef COMPILED_BEHAVIORS
+#include "CompiledBehaviors.h"
+#endif
+
+/**
+ * Behavior tree of a single own unit.
+ *
+ * The tree is loaded from @p behaviorFile in @p behaviorsPath and rebuilt by @p reloader, if
+ * given, when the file changes. Builds with COMPILED_BEHAVIORS always run the compiled main
+ * behavior instead.
+ *
+ * Every unit has its own tree, blackboard and per-unit caches, and only reads the shared world
+ * state, so controllers of different units can tick concurrently.
+ */
+class UnitController
+{
+public:
+    UnitController(const DerivedConstants &constants,
+                   const StrategyParameters &parameters,
+                   const model::Game &game,
+                   const EnemyMap &enemies,
+                   const ZonePredictor &zonePredictor,
+                   const ObstacleIndex &obstacleIndex,
+                   const DangerMap &dangerMap,
+                   std::string behaviorsPath,
+                   std::string behaviorFile,
+                   bool logTransitions,
+                   TreeReloader *reloader = nullptr);
+
+    UnitController(const UnitController &) = delete;
+    UnitController &operator=(const UnitController &) = delete;
+
+    /**
+     * @return Order for @p unit, or nothing if its tree failed.
+     */
+    std::optional<model::UnitOrder> tick(const model::Unit &unit);
+    void finish();
+
+private:
+    void registerNodes();
+    void initTree(TreeReloader *reloader);
+    void setTree(BT::Tree &&tree);
+
+private:
+    BT::BehaviorTreeFactory m_factory;
+    BT::Tree m_tree;
+    std::unique_ptr<BT::StdCoutLogger> m_logger;
+    std::unique_ptr<TreeProfiler> m_profiler;
+    std::string m_behaviorsPath;
+    std::string m_behaviorFile;
+    bool m_logTransitions;
+
+    const model::Game &m_game;
+    model::Unit m_unit;
+    model::UnitOrder m_order;
+    WorldFacts m_facts;
+    LocalAvoidance m_localAvoidance;
+    Actions m_actions;
+#ifdef COMPILED_BEHAVIORS
+    compiled::MainBehavior m_compiledTree{m_actions};
+#endif
+
+    // trees are built on the reloader's thread with the members above, must be destroyed first
+    std::unique_ptr<TreeReloader::Subscription> m_reload;
+};
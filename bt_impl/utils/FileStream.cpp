@@ -0,0 +1,32 @@
+#include "FileStream.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+FileStream::FileStream(const string &path, ios::openmode mode) : m_file{path, mode | ios::binary}
+{
+    if (!m_file)
+        throw runtime_error("Failed to open " + path);
+}
+
+void FileStream::readBytes(char *buffer, size_t byteCount)
+{
+    if (!m_file.read(buffer, static_cast<streamsize>(byteCount)))
+        throw runtime_error("Unexpected end of file");
+}
+
+void FileStream::writeBytes(const char *buffer, size_t byteCount)
+{
+    m_file.write(buffer, static_cast<streamsize>(byteCount));
+}
+
+void FileStream::flush()
+{
+    m_file.flush();
+}
+
+bool FileStream::atEnd()
+{
+    return m_file.peek() == char_traits<char>::eof();
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include "Stream.hpp"
+
+/**
+ * Stream of the client protocol backed by a file, used to record games and replay them offline.
+ */
+class FileStream : public InputStream, public OutputStream
+{
+public:
+    FileStream(const std::string &path, std::ios::openmode mode);
+
+    void readBytes(char *buffer, size_t byteCount) override;
+    void writeBytes(const char *buffer, size_t byteCount) override;
+    void flush() override;
+
+    /**
+     * @return Whether everything has been read.
+     */
+    bool atEnd();
+
+private:
+    std::fstream m_file;
+};
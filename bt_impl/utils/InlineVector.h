@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+/**
+ * Vector of at most N elements stored inline, for lists whose size is only known at run time but
+ * bounded, so their owner copies without allocating and keeps them in its own cache lines.
+ */
+template<typename T, size_t N>
+class InlineVector
+{
+public:
+    InlineVector() = default;
+    explicit InlineVector(size_t size) { resize(size); }
+
+    static constexpr size_t capacity() { return N; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    /**
+     * New elements are value-initialized.
+     *
+     * @throw std::length_error if @p size is over the capacity.
+     */
+    void resize(size_t size)
+    {
+        if (size > N)
+            throw std::length_error("InlineVector capacity exceeded");
+        if (size > m_size)
+            std::fill(m_data.begin() + m_size, m_data.begin() + size, T{});
+        m_size = size;
+    }
+
+    /**
+     * @throw std::length_error if the vector is full.
+     */
+    void push_back(const T &value)
+    {
+        resize(m_size + 1);
+        m_data[m_size - 1] = value;
+    }
+
+    T &operator[](size_t index) { return m_data[index]; }
+    const T &operator[](size_t index) const { return m_data[index]; }
+
+    /**
+     * @throw std::out_of_range if @p index is out of the vector.
+     */
+    const T &at(size_t index) const
+    {
+        if (index >= m_size)
+            throw std::out_of_range("InlineVector index out of range");
+        return m_data[index];
+    }
+
+    T *data() { return m_data.data(); }
+    const T *data() const { return m_data.data(); }
+    T *begin() { return m_data.data(); }
+    T *end() { return m_data.data() + m_size; }
+    const T *begin() const { return m_data.data(); }
+    const T *end() const { return m_data.data() + m_size; }
+
+private:
+    std::array<T, N> m_data{};
+    size_t m_size = 0;
+};
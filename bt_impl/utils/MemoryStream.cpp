@@ -0,0 +1,28 @@
+#include "MemoryStream.h"
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+void MemoryStream::readBytes(char *buffer, size_t byteCount)
+{
+    if (m_buffer.size() - m_position < byteCount)
+        throw runtime_error("Unexpected end of stream");
+
+    memcpy(buffer, m_buffer.data() + m_position, byteCount);
+    m_position += byteCount;
+}
+
+void MemoryStream::writeBytes(const char *buffer, size_t byteCount)
+{
+    m_buffer.insert(end(m_buffer), buffer, buffer + byteCount);
+}
+
+void MemoryStream::flush() {}
+
+void MemoryStream::clear()
+{
+    m_buffer.clear();
+    m_position = 0;
+}
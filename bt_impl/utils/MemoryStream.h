@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+
+#include "Stream.hpp"
+
+/**
+ * Stream of the client protocol backed by a growing buffer, reads start at the beginning.
+ */
+class MemoryStream : public InputStream, public OutputStream
+{
+public:
+    void readBytes(char *buffer, size_t byteCount) override;
+    void writeBytes(const char *buffer, size_t byteCount) override;
+    void flush() override;
+
+    /**
+     * Drops the content but keeps the buffer, so writing the same amount again doesn't allocate.
+     */
+    void clear();
+    const std::vector<char> &data() const { return m_buffer; }
+
+private:
+    std::vector<char> m_buffer;
+    size_t m_position = 0;
+};
@@ -0,0 +1,59 @@
+#include "TcpListener.h"
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+void closeSocket(SOCKET socket)
+{
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    close(socket);
+#endif
+}
+
+} // namespace
+
+TcpListener::TcpListener(int port)
+{
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(1, 1), &wsaData) != 0)
+        throw runtime_error("Failed to initialize sockets");
+#endif
+    m_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_socket == -1)
+        throw runtime_error("Failed to create socket");
+
+    // a restarted server gets its port back while the old connections linger
+    int yes = 1;
+    setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<char *>(&yes), sizeof(yes));
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (::bind(m_socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+        || listen(m_socket, 1) != 0) {
+        closeSocket(m_socket);
+        throw runtime_error("Failed to listen on port " + to_string(port));
+    }
+}
+
+TcpListener::~TcpListener()
+{
+    closeSocket(m_socket);
+}
+
+unique_ptr<TcpStream> TcpListener::accept()
+{
+    const auto client = ::accept(m_socket, nullptr, nullptr);
+    if (client == -1)
+        throw runtime_error("Failed to accept a client");
+    return make_unique<TcpStream>(client);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+
+#include "TcpStream.hpp"
+
+/**
+ * Server side of the client protocol's TCP connection, for tools that stand in for the game
+ * server.
+ */
+class TcpListener
+{
+public:
+    /**
+     * Listens on @p port of all interfaces.
+     *
+     * @throw std::runtime_error if the port can't be listened on.
+     */
+    explicit TcpListener(int port);
+    ~TcpListener();
+
+    TcpListener(const TcpListener &) = delete;
+    TcpListener &operator=(const TcpListener &) = delete;
+
+    /**
+     * Waits for the next client.
+     */
+    std::unique_ptr<TcpStream> accept();
+
+private:
+    SOCKET m_socket;
+};
@@ -0,0 +1,88 @@
+#include "ThreadPool.h"
+
+#include <utility>
+
+using namespace std;
+
+ThreadPool::ThreadPool(size_t workers)
+{
+    m_threads.reserve(workers);
+    for (size_t i = 0; i < workers; ++i)
+        m_threads.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard lock{m_mutex};
+        m_stopped = true;
+    }
+    m_wake.notify_all();
+    for (auto &thread : m_threads)
+        thread.join();
+}
+
+void ThreadPool::run(size_t count, const function<void(size_t)> &task)
+{
+    if (m_threads.empty() || count <= 1) {
+        for (size_t i = 0; i < count; ++i)
+            task(i);
+        return;
+    }
+
+    {
+        lock_guard lock{m_mutex};
+        m_task = &task;
+        m_count = count;
+        m_next = 0;
+        m_error = nullptr;
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    drain(task, count);
+
+    unique_lock lock{m_mutex};
+    // workers still inside drain() may be calling the task
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_task = nullptr;
+    if (m_error)
+        rethrow_exception(exchange(m_error, nullptr));
+}
+
+void ThreadPool::work()
+{
+    uint64_t generation = 0;
+    unique_lock lock{m_mutex};
+    while (true) {
+        m_wake.wait(lock, [&] { return m_stopped || m_generation != generation; });
+        if (m_stopped)
+            return;
+
+        generation = m_generation;
+        const auto *task = m_task;
+        const auto count = m_count;
+        if (!task)
+            continue;
+
+        ++m_busy;
+        lock.unlock();
+        drain(*task, count);
+        lock.lock();
+        if (--m_busy == 0)
+            m_done.notify_one();
+    }
+}
+
+void ThreadPool::drain(const function<void(size_t)> &task, size_t count)
+{
+    for (auto i = m_next++; i < count; i = m_next++) {
+        try {
+            task(i);
+        } catch (...) {
+            lock_guard lock{m_mutex};
+            if (!m_error)
+                m_error = current_exception();
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads running parallel loops.
+ *
+ * The calling thread takes part in every loop, so a pool without workers runs it inline and a
+ * loop never waits for a thread to be created.
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t workers);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * Calls @p task for every index in [0, count) and waits for all of them. The first exception
+     * thrown by a task is rethrown here.
+     */
+    void run(size_t count, const std::function<void(size_t)> &task);
+
+private:
+    void work();
+    void drain(const std::function<void(size_t)> &task, size_t count);
+
+private:
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(size_t)> *m_task = nullptr;
+    size_t m_count = 0;
+    uint64_t m_generation = 0;
+    size_t m_busy = 0;
+    bool m_stopped = false;
+    std::exception_ptr m_error;
+
+    std::atomic<size_t> m_next = 0;
+};
@@ -0,0 +1,31 @@
+#include "TickArena.h"
+
+using namespace std;
+
+TickArena::TickArena(size_t size) : m_size{size}, m_buffer{new byte[size]}
+{
+    m_resource.emplace(m_buffer.get(), m_size, pmr::new_delete_resource());
+}
+
+void TickArena::reset()
+{
+    m_resource.reset();
+    if (m_used > m_size) {
+        // headroom for ticks that grow a bit more
+        m_size = m_used + m_used / 2;
+        m_buffer.reset(new byte[m_size]);
+    }
+    m_used = 0;
+    m_resource.emplace(m_buffer.get(), m_size, pmr::new_delete_resource());
+}
+
+void *TickArena::do_allocate(size_t bytes, size_t alignment)
+{
+    m_used += bytes + alignment - 1;
+    return m_resource->allocate(bytes, alignment);
+}
+
+bool TickArena::do_is_equal(const pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+/**
+ * Memory of everything that lives for a single tick, all of it released at once by `reset`.
+ *
+ * An allocation is a pointer bump in one buffer and deallocation does nothing. A tick that needs
+ * more than the buffer takes the rest from the heap, and the next `reset` grows the buffer to fit
+ * it, so steady-state ticks stay in the same buffer without touching the heap.
+ *
+ * Not thread-safe.
+ */
+class TickArena : public std::pmr::memory_resource
+{
+public:
+    explicit TickArena(size_t size = 1 << 20);
+
+    /**
+     * Releases all allocations since the previous reset, nothing allocated from the arena may be
+     * used or destroyed after it.
+     */
+    void reset();
+
+    size_t size() const { return m_size; }
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+private:
+    size_t m_size;
+    std::unique_ptr<std::byte[]> m_buffer;
+    // upper bound of the memory requested since the previous reset, including alignment
+    size_t m_used = 0;
+    std::optional<std::pmr::monotonic_buffer_resource> m_resource;
+};
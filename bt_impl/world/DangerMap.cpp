@@ -0,0 +1,469 @@
+#include "DangerMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+using namespace std;
+using namespace model;
+using namespace debugging;
+
+constexpr auto DRAW_LEVELS = 8;
+constexpr auto DRAW_MAX_ALPHA = 0.6;
+
+namespace {
+
+constexpr auto EMPTY_SPAN = pair{numeric_limits<double>::infinity(),
+                                 -numeric_limits<double>::infinity()};
+
+/**
+ * @return Span of x on the horizontal line at @p y within @p radius of @p center, left > right
+ * if there is none.
+ */
+pair<double, double> chord(double y, const Vec2 &center, double radius)
+{
+    const auto dy = y - center.y;
+    if (dy * dy > radius * radius)
+        return EMPTY_SPAN;
+
+    const auto halfChord = sqrt(radius * radius - dy * dy);
+    return {center.x - halfChord, center.x + halfChord};
+}
+
+/**
+ * @return Span of u with @p low <= @p slope * u + @p offset <= @p high, left > right if there is
+ * none.
+ */
+pair<double, double> linearSpan(double slope, double offset, double low, double high)
+{
+    if (slope == 0) {
+        return offset >= low && offset <= high ? pair{-numeric_limits<double>::infinity(),
+                                                      numeric_limits<double>::infinity()}
+                                               : EMPTY_SPAN;
+    }
+    const auto first = (low - offset) / slope;
+    const auto second = (high - offset) / slope;
+    return {min(first, second), max(first, second)};
+}
+
+double segmentSqrDistance(const Vec2 &point, const Vec2 &begin, const Vec2 &direction, double length)
+{
+    const auto t = clamp(dotProduct(point - begin, direction), 0.0, length);
+    return (point - (begin + direction * t)).sqrLength();
+}
+
+/**
+ * Inserts an empty stamp for @p key into a node of a stamp erased before, so its cells keep their
+ * capacity.
+ */
+template<typename Stamps>
+typename Stamps::iterator insertStamp(Stamps &stamps,
+                                      vector<typename Stamps::node_type> &spare,
+                                      int key)
+{
+    if (spare.empty())
+        return stamps.try_emplace(key).first;
+
+    auto node = move(spare.back());
+    spare.pop_back();
+    auto cells = move(node.mapped().cells);
+    cells.clear();
+    node.mapped() = {};
+    node.mapped().cells = move(cells);
+    node.key() = key;
+    return stamps.insert(move(node)).position;
+}
+
+/**
+ * Erases stamps matching @p predicate and keeps their nodes for insertStamp.
+ */
+template<typename Stamps, typename Predicate>
+void eraseStamps(Stamps &stamps, vector<typename Stamps::node_type> &spare, Predicate predicate)
+{
+    for (auto it = begin(stamps); it != end(stamps);) {
+        const auto current = it++;
+        if (predicate(*current))
+            spare.push_back(stamps.extract(current));
+    }
+}
+
+} // namespace
+
+DangerMap::DangerMap(const DerivedConstants &constants, double cellSize)
+    : m_constants{constants.constants()},
+      m_derived{constants},
+      m_cellSize{cellSize},
+      m_origin{-m_constants.initialZoneRadius},
+      m_size{static_cast<int>(ceil(2 * m_constants.initialZoneRadius / cellSize))},
+      m_zone(m_size * m_size),
+      m_projectiles(m_size * m_size),
+      m_enemies(m_size * m_size),
+      m_rowPrefix(m_size * (m_size + 1)),
+      m_areaPrefix((m_size + 1) * (m_size + 1)),
+      m_dirtyBegin{m_size}
+{
+    // cells are stamped if their centers are within unitRadius of the path, their number is
+    // bounded by the area and perimeter of that stadium in cells
+    const auto radius = m_constants.unitRadius;
+    for (size_t i = 0; i < m_constants.weapons.size(); ++i) {
+        const auto length = constants.weapon(i).range;
+        const auto area = 2 * radius * length + numbers::pi * radius * radius;
+        const auto perimeter = 2 * length + 2 * numbers::pi * radius;
+        const auto cells = area / (cellSize * cellSize) + perimeter / cellSize + 1;
+        m_maxProjectileCells = max(m_maxProjectileCells, static_cast<size_t>(ceil(cells)));
+    }
+}
+
+void DangerMap::update(const Game &game)
+{
+    updateZone(game.zone);
+    updateProjectiles(game);
+    updateEnemies(game);
+    updatePrefixSums();
+}
+
+double DangerMap::danger(const Vec2 &position) const
+{
+    return cellTotal(row(position.y) * m_size + column(position.x));
+}
+
+double DangerMap::rectDanger(const Vec2 &bottomLeft, const Vec2 &topRight) const
+{
+    const auto stride = m_size + 1;
+    const auto c0 = column(bottomLeft.x);
+    const auto c1 = column(topRight.x) + 1;
+    const auto r0 = row(bottomLeft.y);
+    const auto r1 = row(topRight.y) + 1;
+    return m_areaPrefix[r1 * stride + c1] - m_areaPrefix[r0 * stride + c1]
+           - m_areaPrefix[r1 * stride + c0] + m_areaPrefix[r0 * stride + c0];
+}
+
+double DangerMap::pathDanger(const Vec2 &from, const Vec2 &to, double radius) const
+{
+    const auto stride = m_size + 1;
+    auto result = 0.0;
+    for (int r = row(min(from.y, to.y) - radius); r <= row(max(from.y, to.y) + radius); ++r) {
+        const auto [first, end] = pathColumns(r, from, to, radius);
+        result += m_rowPrefix[r * stride + end] - m_rowPrefix[r * stride + first];
+    }
+    return result;
+}
+
+void DangerMap::draw(DebugInterface &debugInterface) const
+{
+    auto maxDanger = 0.0;
+    for (int i = 0; i < m_size * m_size; ++i)
+        maxDanger = max(maxDanger, cellTotal(i));
+    if (maxDanger <= 0)
+        return;
+
+    const auto level = [&](int index) {
+        return static_cast<int>(ceil(cellTotal(index) / maxDanger * DRAW_LEVELS));
+    };
+
+    // merge runs of cells with the same level into one quad to keep the debug stream small
+    for (int r = 0; r < m_size; ++r) {
+        for (int c = 0; c < m_size;) {
+            const auto current = level(r * m_size + c);
+            auto end = c + 1;
+            while (end < m_size && level(r * m_size + end) == current)
+                ++end;
+
+            if (current > 0) {
+                const auto color = Color{1, 0, 0, DRAW_MAX_ALPHA * current / DRAW_LEVELS};
+                const auto x0 = m_origin + c * m_cellSize;
+                const auto x1 = m_origin + end * m_cellSize;
+                const auto y0 = m_origin + r * m_cellSize;
+                const auto y1 = y0 + m_cellSize;
+                debugInterface.addGradientPolygon({ColoredVertex{Vec2{x0, y0}, color},
+                                                   ColoredVertex{Vec2{x1, y0}, color},
+                                                   ColoredVertex{Vec2{x1, y1}, color},
+                                                   ColoredVertex{Vec2{x0, y1}, color}});
+            }
+            c = end;
+        }
+    }
+}
+
+int DangerMap::column(double x) const
+{
+    return clamp(static_cast<int>(floor((x - m_origin) / m_cellSize)), 0, m_size - 1);
+}
+
+int DangerMap::row(double y) const
+{
+    return column(y);
+}
+
+Vec2 DangerMap::cellCenter(int row, int column) const
+{
+    return Vec2{m_origin + (column + 0.5) * m_cellSize, m_origin + (row + 0.5) * m_cellSize};
+}
+
+double DangerMap::cellTotal(int index) const
+{
+    return m_zone[index] + m_projectiles[index] + m_enemies[index];
+}
+
+void DangerMap::markDirty(int row)
+{
+    m_dirtyBegin = min(m_dirtyBegin, row);
+    m_dirtyEnd = max(m_dirtyEnd, row + 1);
+}
+
+void DangerMap::updateZone(const Zone &zone)
+{
+    if (m_zoneInitialized && zone.currentCenter == m_zoneCenter
+        && realNearlyEqual(zone.currentRadius, m_zoneRadius)) {
+        return;
+    }
+
+    auto rowBegin = row(zone.currentCenter.y - zone.currentRadius);
+    auto rowEnd = row(zone.currentCenter.y + zone.currentRadius) + 1;
+    if (m_zoneInitialized) {
+        rowBegin = min(rowBegin, row(m_zoneCenter.y - m_zoneRadius));
+        rowEnd = max(rowEnd, row(m_zoneCenter.y + m_zoneRadius) + 1);
+    } else {
+        fill(begin(m_zone), end(m_zone), m_derived.zoneDamagePerTick());
+        markDirty(0);
+        markDirty(m_size - 1);
+    }
+
+    for (int r = rowBegin; r < rowEnd; ++r) {
+        const auto [oldBegin, oldEnd] = m_zoneInitialized
+                                            ? circleColumns(r, m_zoneCenter, m_zoneRadius)
+                                            : pair{0, 0};
+        const auto [newBegin, newEnd] = circleColumns(r, zone.currentCenter, zone.currentRadius);
+        const auto update = [&](int from, int to) {
+            for (int c = from; c < to; ++c)
+                setZoneCell(r, c, c >= newBegin && c < newEnd);
+        };
+
+        if (oldBegin < oldEnd && newBegin < newEnd && oldBegin < newEnd && newBegin < oldEnd) {
+            // overlapping chords: only the cells between the chord ends change
+            update(min(oldBegin, newBegin), max(oldBegin, newBegin));
+            update(min(oldEnd, newEnd), max(oldEnd, newEnd));
+        } else {
+            update(oldBegin, oldEnd);
+            update(newBegin, newEnd);
+        }
+    }
+
+    m_zoneInitialized = true;
+    m_zoneCenter = zone.currentCenter;
+    m_zoneRadius = zone.currentRadius;
+}
+
+void DangerMap::updateProjectiles(const Game &game)
+{
+    const auto radius = m_constants.unitRadius;
+    const auto stamp = [&](const vector<pair<double, int>> &cells,
+                           size_t first,
+                           size_t last,
+                           double value) {
+        for (auto i = first; i < last; ++i) {
+            m_projectiles[cells[i].second] += value;
+            markDirty(cells[i].second / m_size);
+        }
+    };
+
+    for (const auto &projectile : game.projectiles) {
+        if (projectile.shooterPlayerId == game.myId)
+            continue;
+
+        auto it = m_projectileStamps.find(projectile.id);
+        if (it == end(m_projectileStamps)) {
+            const auto speed = projectile.velocity.length();
+            if (speed <= 0)
+                continue;
+
+            it = insertStamp(m_projectileStamps, m_spareProjectileStamps, projectile.id);
+            auto &projectileStamp = it->second;
+            projectileStamp.origin = projectile.position;
+            projectileStamp.direction = projectile.velocity * (1 / speed);
+            projectileStamp.damage = m_constants.weapons.at(projectile.weaponTypeIndex)
+                                         .projectileDamage;
+            // stamps are reused, so after a while none of them has to grow
+            projectileStamp.cells.reserve(m_maxProjectileCells);
+
+            const auto length = speed * projectile.lifeTime;
+            const auto target = projectile.position + projectileStamp.direction * length;
+            const auto r0 = row(min(projectile.position.y, target.y) - radius);
+            const auto r1 = row(max(projectile.position.y, target.y) + radius);
+            const auto c0 = column(min(projectile.position.x, target.x) - radius);
+            const auto c1 = column(max(projectile.position.x, target.x) + radius);
+            for (int r = r0; r <= r1; ++r) {
+                for (int c = c0; c <= c1; ++c) {
+                    const auto center = cellCenter(r, c);
+                    if (segmentSqrDistance(center, projectile.position, projectileStamp.direction, length)
+                        <= radius * radius) {
+                        projectileStamp.cells.emplace_back(
+                            dotProduct(center - projectile.position, projectileStamp.direction),
+                            r * m_size + c);
+                    }
+                }
+            }
+            sort(begin(projectileStamp.cells), end(projectileStamp.cells));
+            stamp(projectileStamp.cells, 0, projectileStamp.cells.size(), projectileStamp.damage);
+        }
+
+        // drop the cells the projectile has already flown past
+        auto &projectileStamp = it->second;
+        const auto travelled = dotProduct(projectile.position - projectileStamp.origin,
+                                          projectileStamp.direction);
+        const auto first = projectileStamp.firstAlive;
+        while (projectileStamp.firstAlive < projectileStamp.cells.size()
+               && projectileStamp.cells[projectileStamp.firstAlive].first < travelled - radius) {
+            ++projectileStamp.firstAlive;
+        }
+        stamp(projectileStamp.cells, first, projectileStamp.firstAlive, -projectileStamp.damage);
+        projectileStamp.lastSeenTick = game.currentTick;
+    }
+
+    eraseStamps(m_projectileStamps, m_spareProjectileStamps, [&](const auto &entry) {
+        const auto &[id, projectileStamp] = entry;
+        if (projectileStamp.lastSeenTick == game.currentTick)
+            return false;
+
+        stamp(projectileStamp.cells,
+              projectileStamp.firstAlive,
+              projectileStamp.cells.size(),
+              -projectileStamp.damage);
+        return true;
+    });
+}
+
+void DangerMap::updateEnemies(const Game &game)
+{
+    const auto stamp = [&](const vector<int> &cells, double value) {
+        for (const auto cell : cells) {
+            m_enemies[cell] += value;
+            markDirty(cell / m_size);
+        }
+    };
+
+    const auto &units = game.unitTable;
+    for (size_t i = 0; i < units.size(); ++i) {
+        const auto weaponIndex = units.weapon[i];
+        if (units.playerId[i] == game.myId || weaponIndex < 0 || !units.spawned[i])
+            continue;
+
+        const auto &position = units.position[i];
+        const auto cell = row(position.y) * m_size + column(position.x);
+        auto it = m_enemyStamps.find(units.id[i]);
+        if (it == end(m_enemyStamps))
+            it = insertStamp(m_enemyStamps, m_spareEnemyStamps, units.id[i]);
+
+        auto &enemyStamp = it->second;
+        enemyStamp.lastSeenTick = game.currentTick;
+        if (enemyStamp.cell == cell && enemyStamp.weapon == weaponIndex)
+            continue;
+
+        stamp(enemyStamp.cells, -enemyStamp.value);
+
+        const auto &weapon = m_derived.weapon(weaponIndex);
+        enemyStamp.cell = cell;
+        enemyStamp.weapon = weaponIndex;
+        enemyStamp.value = weapon.damagePerTick;
+        discCells(position, weapon.range, enemyStamp.cells);
+        stamp(enemyStamp.cells, enemyStamp.value);
+    }
+
+    eraseStamps(m_enemyStamps, m_spareEnemyStamps, [&](const auto &entry) {
+        const auto &[id, enemyStamp] = entry;
+        if (enemyStamp.lastSeenTick == game.currentTick)
+            return false;
+
+        stamp(enemyStamp.cells, -enemyStamp.value);
+        return true;
+    });
+}
+
+void DangerMap::updatePrefixSums()
+{
+    const auto stride = m_size + 1;
+    for (int r = m_dirtyBegin; r < m_dirtyEnd; ++r) {
+        m_rowPrefix[r * stride] = 0;
+        for (int c = 0; c < m_size; ++c) {
+            m_rowPrefix[r * stride + c + 1] = m_rowPrefix[r * stride + c]
+                                              + cellTotal(r * m_size + c);
+        }
+    }
+
+    // area prefix of every row depends on all rows above it
+    for (int r = m_dirtyBegin; r < m_size; ++r) {
+        for (int c = 0; c <= m_size; ++c) {
+            m_areaPrefix[(r + 1) * stride + c] = m_areaPrefix[r * stride + c]
+                                                 + m_rowPrefix[r * stride + c];
+        }
+    }
+
+    m_dirtyBegin = m_size;
+    m_dirtyEnd = 0;
+}
+
+pair<int, int> DangerMap::spanColumns(double left, double right) const
+{
+    if (left > right)
+        return {0, 0};
+
+    const auto first = static_cast<int>(ceil((left - m_origin) / m_cellSize - 0.5));
+    const auto last = static_cast<int>(floor((right - m_origin) / m_cellSize - 0.5));
+    const auto clampedFirst = max(first, 0);
+    const auto clampedEnd = min(last + 1, m_size);
+    return clampedFirst < clampedEnd ? pair{clampedFirst, clampedEnd} : pair{0, 0};
+}
+
+pair<int, int> DangerMap::circleColumns(int row, const Vec2 &center, double radius) const
+{
+    const auto [left, right] = chord(cellCenter(row, 0).y, center, radius);
+    return spanColumns(left, right);
+}
+
+pair<int, int> DangerMap::pathColumns(int row,
+                                      const Vec2 &from,
+                                      const Vec2 &to,
+                                      double radius) const
+{
+    const auto y = cellCenter(row, 0).y;
+    auto span = chord(y, from, radius);
+    const auto unite = [&span](const pair<double, double> &other) {
+        if (other.first <= other.second) {
+            span.first = min(span.first, other.first);
+            span.second = max(span.second, other.second);
+        }
+    };
+    unite(chord(y, to, radius));
+
+    // the band between the end discs: points projecting onto the segment within radius of it,
+    // the spans are relative to from.x
+    const auto length = (to - from).length();
+    if (length > 0) {
+        const auto direction = (to - from) * (1 / length);
+        const auto along = linearSpan(direction.x, (y - from.y) * direction.y, 0, length);
+        const auto across = linearSpan(direction.y, -(y - from.y) * direction.x, -radius, radius);
+        unite({from.x + max(along.first, across.first), from.x + min(along.second, across.second)});
+    }
+    return spanColumns(span.first, span.second);
+}
+
+void DangerMap::setZoneCell(int row, int column, bool inside)
+{
+    const auto value = inside ? 0.0 : m_derived.zoneDamagePerTick();
+    auto &cell = m_zone[row * m_size + column];
+    if (cell != value) {
+        cell = value;
+        markDirty(row);
+    }
+}
+
+void DangerMap::discCells(const Vec2 &center, double radius, vector<int> &cells) const
+{
+    cells.clear();
+    for (int r = row(center.y - radius); r <= row(center.y + radius); ++r) {
+        const auto [first, last] = circleColumns(r, center, radius);
+        for (int c = first; c < last; ++c)
+            cells.push_back(r * m_size + c);
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "DebugInterface.hpp"
+#include "model/Game.hpp"
+#include "world/DerivedConstants.h"
+
+/**
+ * Shared threat raster over the whole map, updated once per tick. GoToTarget avoids its
+ * dangerous cells on the way to the target.
+ *
+ * Every cell accumulates three layers of danger (in health points):
+ * - zone: damage per tick when the cell center lies outside the current zone,
+ * - projectiles: damage of every enemy projectile whose remaining sweep (inflated by the unit
+ *   radius) covers the cell,
+ * - enemies: expected damage per tick from every enemy whose weapon reaches the cell.
+ *
+ * Updates are incremental: each layer remembers what it stamped last tick and only touches cells
+ * whose inputs changed. Row and area prefix sums are rebuilt for dirty rows only, so queries are
+ * O(1) per rectangle and O(1) per row a path covers.
+ */
+class DangerMap
+{
+public:
+    DangerMap(const DerivedConstants &constants, double cellSize = 2.0);
+
+    void update(const model::Game &game);
+
+    double danger(const model::Vec2 &position) const;
+    double rectDanger(const model::Vec2 &bottomLeft, const model::Vec2 &topRight) const;
+    /**
+     * @return Sum of danger over the cells covered by a disc of @p radius moving from @p from to
+     * @p to, i.e. the cells whose centers are within @p radius of the path, each counted once.
+     */
+    double pathDanger(const model::Vec2 &from, const model::Vec2 &to, double radius) const;
+
+    void draw(DebugInterface &debugInterface) const;
+
+private:
+    struct ProjectileStamp
+    {
+        model::Vec2 origin;
+        model::Vec2 direction;
+        double damage = 0;
+        // stamped cells sorted by their projection on the projectile's direction
+        std::vector<std::pair<double, int>> cells;
+        size_t firstAlive = 0;
+        int lastSeenTick = -1;
+    };
+
+    struct EnemyStamp
+    {
+        int cell = -1;
+        int weapon = -1;
+        double value = 0;
+        std::vector<int> cells;
+        int lastSeenTick = -1;
+    };
+
+    int column(double x) const;
+    int row(double y) const;
+    model::Vec2 cellCenter(int row, int column) const;
+    double cellTotal(int index) const;
+    void markDirty(int row);
+
+    void updateZone(const model::Zone &zone);
+    void updateProjectiles(const model::Game &game);
+    void updateEnemies(const model::Game &game);
+    void updatePrefixSums();
+
+    /**
+     * @return Columns [first, end) whose centers lie in [@p left, @p right], empty if none do.
+     */
+    std::pair<int, int> spanColumns(double left, double right) const;
+    std::pair<int, int> circleColumns(int row, const model::Vec2 &center, double radius) const;
+    /**
+     * @return Columns of @p row whose centers are within @p radius of the segment from @p from to
+     * @p to, one run because that region is convex.
+     */
+    std::pair<int, int> pathColumns(int row,
+                                    const model::Vec2 &from,
+                                    const model::Vec2 &to,
+                                    double radius) const;
+    void setZoneCell(int row, int column, bool inside);
+    /**
+     * Replaces @p cells by the cells whose centers are within @p radius of @p center.
+     */
+    void discCells(const model::Vec2 &center, double radius, std::vector<int> &cells) const;
+
+private:
+    const model::Constants &m_constants;
+    const DerivedConstants &m_derived;
+    const double m_cellSize;
+    const double m_origin;
+    const int m_size;
+
+    std::vector<double> m_zone;
+    std::vector<double> m_projectiles;
+    std::vector<double> m_enemies;
+    // (m_size + 1) entries per row, leading zero
+    std::vector<double> m_rowPrefix;
+    // (m_size + 1) x (m_size + 1), leading zero row and column
+    std::vector<double> m_areaPrefix;
+
+    bool m_zoneInitialized = false;
+    model::Vec2 m_zoneCenter;
+    double m_zoneRadius = 0;
+    std::unordered_map<int, ProjectileStamp> m_projectileStamps;
+    // upper bound of the cells stamped by a projectile of any weapon
+    size_t m_maxProjectileCells = 0;
+    std::unordered_map<int, EnemyStamp> m_enemyStamps;
+    // nodes of erased stamps, reused for new ones so that a tick doesn't allocate
+    std::vector<std::unordered_map<int, ProjectileStamp>::node_type> m_spareProjectileStamps;
+    std::vector<std::unordered_map<int, EnemyStamp>::node_type> m_spareEnemyStamps;
+
+    int m_dirtyBegin;
+    int m_dirtyEnd = 0;
+};
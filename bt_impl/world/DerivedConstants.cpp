@@ -0,0 +1,24 @@
+#include "DerivedConstants.h"
+
+#include <cmath>
+#include <numbers>
+
+using namespace std;
+using namespace model;
+
+DerivedConstants::DerivedConstants(Constants constants)
+    : m_constants{move(constants)},
+      m_zoneDamagePerTick{m_constants.zoneDamagePerSecond / m_constants.ticksPerSecond},
+      m_zoneRadiusPerTick{m_constants.zoneSpeed / m_constants.ticksPerSecond},
+      m_cosHalfFieldOfView{cos(m_constants.fieldOfView / 2 * numbers::pi / 180)}
+{
+    for (const auto &weapon : m_constants.weapons) {
+        const auto range = weapon.projectileSpeed * weapon.projectileLifeTime;
+        m_weapons.push_back(Weapon{range,
+                                   weapon.projectileDamage * weapon.roundsPerSecond
+                                       / m_constants.ticksPerSecond});
+    }
+
+    for (const auto &obstacle : m_constants.obstacles)
+        m_inflatedObstacleRadii.push_back(m_constants.unitRadius + obstacle.radius);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include "model/Constants.hpp"
+
+/**
+ * The game constants together with the values derived from them, computed once per game.
+ *
+ * This is the only copy of the constants, everything else refers to it, so it can't be copied.
+ */
+class DerivedConstants
+{
+public:
+    struct Weapon
+    {
+        // distance a projectile flies in its lifetime
+        double range = 0;
+        // damage of continuous fire per tick
+        double damagePerTick = 0;
+    };
+
+    explicit DerivedConstants(model::Constants constants);
+
+    DerivedConstants(const DerivedConstants &) = delete;
+    DerivedConstants &operator=(const DerivedConstants &) = delete;
+
+    const model::Constants &constants() const { return m_constants; }
+
+    const Weapon &weapon(int index) const { return m_weapons.at(index); }
+    double zoneDamagePerTick() const { return m_zoneDamagePerTick; }
+    /**
+     * @return Distance the zone radius shrinks by per tick.
+     */
+    double zoneRadiusPerTick() const { return m_zoneRadiusPerTick; }
+    double cosHalfFieldOfView() const { return m_cosHalfFieldOfView; }
+
+    /**
+     * @return Radius of obstacle @p index grown by the unit radius, the distance to its center
+     * a unit center can't come closer than.
+     */
+    double inflatedObstacleRadius(int index) const { return m_inflatedObstacleRadii[index]; }
+
+private:
+    const model::Constants m_constants;
+    std::vector<Weapon> m_weapons;
+    double m_zoneDamagePerTick;
+    double m_zoneRadiusPerTick;
+    double m_cosHalfFieldOfView;
+    std::vector<double> m_inflatedObstacleRadii;
+};
@@ -0,0 +1,269 @@
+#include "GameGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+using namespace std;
+using namespace model;
+
+constexpr auto MY_ID = 1;
+constexpr auto UNIT_RADIUS = 1.0;
+constexpr auto PLACEMENT_ATTEMPTS = 1000;
+// the next zone radius relative to the current one
+constexpr auto ZONE_SHRINK = 0.6;
+// random walk of unit headings per tick, in radians
+constexpr auto HEADING_NOISE = 0.3;
+
+GameGenerator::GameGenerator(const Settings &settings)
+    : m_settings{settings}, m_random{settings.seed}, m_constants{makeConstants()},
+      m_obstacleIndex{m_constants}
+{
+    if (m_settings.units < 1 || m_settings.teamSize < 1)
+        throw runtime_error("at least one unit and one unit per team are needed");
+
+    placeUnits();
+    for (auto i = 0; i < m_settings.projectiles; ++i)
+        m_projectiles.push_back(makeProjectile(true));
+
+    m_zone.currentCenter = Vec2{};
+    m_zone.currentRadius = m_constants.initialZoneRadius;
+    nextZonePhase();
+}
+
+Game GameGenerator::next()
+{
+    const auto playerCount = (m_settings.units + m_settings.teamSize - 1) / m_settings.teamSize;
+    pmr::vector<Player> players;
+    for (auto id = MY_ID; id < MY_ID + playerCount; ++id)
+        players.emplace_back(id, 0, 0, playerCount, 0);
+
+    pmr::vector<Unit> units{m_units};
+    if (m_settings.visibilityPeriod > 0) {
+        const auto period = m_settings.visibilityPeriod;
+        erase_if(units, [this, period](const Unit &unit) {
+            const auto phase = (m_tick + unit.id * period / 4) % period;
+            return unit.playerId != MY_ID && phase >= period / 2;
+        });
+    }
+    Game game{MY_ID, move(players), m_tick, move(units), {}, m_projectiles, m_zone, {}};
+
+    ++m_tick;
+    moveUnits();
+    moveProjectiles();
+    moveZone();
+    return game;
+}
+
+Constants GameGenerator::makeConstants()
+{
+    vector<WeaponProperties> weapons{
+        WeaponProperties{"wand", 2, 10, 0.3, 60, 60, 0.8, 20, 30, 2, {}, {}, 10},
+        WeaponProperties{"staff", 1.5, 20, 0.3, 60, 60, 0.8, 25, 20, 1.5, {}, {}, 10},
+        WeaponProperties{"bow", 1, 5, 1, 30, 30, 0.5, 40, 75, 1, {}, {}, 10},
+    };
+    // ticks, team, zone, spawn, loot, unit, health, shield, respawn, view, movement, scoring,
+    // weapons, potions, sounds, obstacles
+    return Constants{30, m_settings.teamSize, m_settings.zoneRadius, 0.5, 10, 0, 0, 0.5, 0,
+                     UNIT_RADIUS, 100, 5, 5, 100, 0, 0, 0, 90, 60, false, 180, 0, 10, 5, 30,
+                     false, 200, 1, 20, weapons, 0, 100, 2, 50, 1, {}, {}, 10, makeObstacles()};
+}
+
+vector<Obstacle> GameGenerator::makeObstacles()
+{
+    uniform_real_distribution<double> radius{1, 4};
+    bernoulli_distribution seeThrough{0.3};
+    bernoulli_distribution shootThrough{0.2};
+
+    // obstacles keep a unit wide gap between them, so every unit spawned in free space can move
+    vector<Obstacle> obstacles;
+    for (auto id = 0; id < m_settings.obstacles; ++id) {
+        const auto r = radius(m_random);
+        auto attempt = 0;
+        for (; attempt < PLACEMENT_ATTEMPTS; ++attempt) {
+            const auto position = randomPoint(m_settings.zoneRadius - r);
+            const auto overlaps = any_of(cbegin(obstacles), cend(obstacles), [&](const auto &o) {
+                const auto distance = r + o.radius + 2 * UNIT_RADIUS;
+                return (o.position - position).sqrLength() < distance * distance;
+            });
+            if (!overlaps) {
+                obstacles.emplace_back(id, position, r, seeThrough(m_random), shootThrough(m_random));
+                break;
+            }
+        }
+        if (attempt == PLACEMENT_ATTEMPTS)
+            throw runtime_error("obstacles don't fit into the zone");
+    }
+    return obstacles;
+}
+
+void GameGenerator::placeUnits()
+{
+    const auto &weapons = m_constants.weapons;
+    const auto spawnRadius = m_settings.spawnRadius > 0
+                                 ? min(m_settings.spawnRadius, m_constants.initialZoneRadius)
+                                 : m_constants.initialZoneRadius;
+    uniform_real_distribution<double> heading{0, 2 * numbers::pi};
+    uniform_real_distribution<double> shield{0, m_constants.maxShield};
+
+    for (auto i = 0; i < m_settings.units; ++i) {
+        auto attempt = 0;
+        Vec2 position;
+        for (; attempt < PLACEMENT_ATTEMPTS; ++attempt) {
+            position = randomPoint(spawnRadius - UNIT_RADIUS);
+            const auto overlaps = any_of(cbegin(m_units), cend(m_units), [&](const auto &unit) {
+                return (unit.position - position).sqrLength() < 4 * UNIT_RADIUS * UNIT_RADIUS;
+            });
+            if (!overlaps && isFree(position, UNIT_RADIUS, false))
+                break;
+        }
+        if (attempt == PLACEMENT_ATTEMPTS)
+            throw runtime_error("units don't fit into the spawn area");
+
+        const auto weapon = static_cast<int>(m_random() % weapons.size());
+        InlineVector<int, Unit::MAX_WEAPONS> ammo(weapons.size());
+        for (size_t w = 0; w < weapons.size(); ++w)
+            ammo[w] = static_cast<int>(m_random() % (weapons[w].maxInventoryAmmo + 1));
+        ammo[weapon] = max(ammo[weapon], 1);
+
+        const auto angle = heading(m_random);
+        m_headings.push_back(angle);
+        m_units.emplace_back(MY_ID + i,
+                             MY_ID + i / m_settings.teamSize,
+                             m_constants.unitHealth,
+                             shield(m_random),
+                             m_constants.extraLives,
+                             position,
+                             nullopt,
+                             Vec2{},
+                             Vec2{cos(angle), sin(angle)},
+                             0,
+                             nullopt,
+                             0,
+                             weapon,
+                             0,
+                             move(ammo),
+                             static_cast<int>(m_random()
+                                              % (m_constants.maxShieldPotionsInInventory + 1)));
+    }
+}
+
+Projectile GameGenerator::makeProjectile(bool inFlight)
+{
+    uniform_real_distribution<double> angle{0, 2 * numbers::pi};
+    uniform_real_distribution<double> age{0, 1};
+
+    const auto &shooter = m_units[m_random() % m_units.size()];
+    const auto weaponIndex = shooter.weapon.value();
+    const auto &weapon = m_constants.weapons[weaponIndex];
+    const auto a = angle(m_random);
+    const auto velocity = Vec2{cos(a), sin(a)} * weapon.projectileSpeed;
+
+    // a projectile in flight must not have passed through an obstacle it can't, one that was just
+    // shot starts inside its shooter, which is always free
+    auto flightTime = inFlight ? age(m_random) * weapon.projectileLifeTime : 0.0;
+    auto position = shooter.position + velocity * flightTime;
+    if (flightTime > 0 && !isFree(position, 0, true)) {
+        flightTime = 0;
+        position = shooter.position;
+    }
+
+    return Projectile{m_nextProjectileId++,
+                      weaponIndex,
+                      shooter.id,
+                      shooter.playerId,
+                      position,
+                      velocity,
+                      weapon.projectileLifeTime - flightTime};
+}
+
+Vec2 GameGenerator::randomPoint(double radius)
+{
+    uniform_real_distribution<double> unit{0, 1};
+    const auto r = max(radius, 0.0) * sqrt(unit(m_random));
+    const auto a = 2 * numbers::pi * unit(m_random);
+    return Vec2{r * cos(a), r * sin(a)};
+}
+
+bool GameGenerator::isFree(const Vec2 &position, double radius, bool shot) const
+{
+    m_obstacles.clear();
+    m_obstacleIndex.query(position, radius, m_obstacles);
+    return none_of(cbegin(m_obstacles), cend(m_obstacles), [&](int i) {
+        return !shot || !m_constants.obstacles[i].canShootThrough;
+    });
+}
+
+void GameGenerator::moveUnits()
+{
+    const auto dt = 1 / m_constants.ticksPerSecond;
+    const auto step = m_constants.maxUnitForwardSpeed * dt;
+    uniform_real_distribution<double> noise{-HEADING_NOISE, HEADING_NOISE};
+
+    for (size_t i = 0; i < m_units.size(); ++i) {
+        auto &unit = m_units[i];
+        auto &heading = m_headings[i];
+
+        const auto toCenter = m_zone.currentCenter - unit.position;
+        if (toCenter.length() > m_zone.currentRadius - 2 * UNIT_RADIUS)
+            heading = atan2(toCenter.y, toCenter.x);
+        else
+            heading += noise(m_random);
+
+        const auto direction = Vec2{cos(heading), sin(heading)};
+        const auto target = unit.position + direction * step;
+        const auto blocked = any_of(cbegin(m_units), cend(m_units), [&](const auto &other) {
+            return &other != &unit
+                   && (other.position - target).sqrLength() < 4 * UNIT_RADIUS * UNIT_RADIUS;
+        });
+
+        unit.direction = direction;
+        if (blocked || !isFree(target, UNIT_RADIUS, false)) {
+            unit.velocity = Vec2{};
+            heading += numbers::pi / 2;
+        } else {
+            unit.velocity = direction * m_constants.maxUnitForwardSpeed;
+            unit.position = target;
+        }
+    }
+}
+
+void GameGenerator::moveProjectiles()
+{
+    const auto dt = 1 / m_constants.ticksPerSecond;
+    for (auto &projectile : m_projectiles) {
+        projectile.position += projectile.velocity * dt;
+        projectile.lifeTime -= dt;
+        if (projectile.lifeTime <= 0 || !isFree(projectile.position, 0, true))
+            projectile = makeProjectile(false);
+    }
+}
+
+void GameGenerator::moveZone()
+{
+    const auto step = m_constants.zoneSpeed / m_constants.ticksPerSecond;
+    if (m_zone.currentRadius <= 0 || step <= 0)
+        return;
+
+    if (m_zone.currentRadius - step > m_zone.nextRadius) {
+        m_zone.currentRadius -= step;
+        m_zone.currentCenter += m_zoneVelocity;
+    } else {
+        m_zone.currentRadius = m_zone.nextRadius;
+        m_zone.currentCenter = m_zone.nextCenter;
+        nextZonePhase();
+    }
+}
+
+void GameGenerator::nextZonePhase()
+{
+    // the next circle lies inside the current one, and both the radius and the center reach it at
+    // the same tick, see ZonePredictor
+    m_zone.nextRadius = m_zone.currentRadius * ZONE_SHRINK;
+    m_zone.nextCenter = m_zone.currentCenter + randomPoint(m_zone.currentRadius - m_zone.nextRadius);
+
+    const auto step = m_constants.zoneSpeed / m_constants.ticksPerSecond;
+    const auto ticks = step > 0 ? (m_zone.currentRadius - m_zone.nextRadius) / step : 0;
+    m_zoneVelocity = ticks > 0 ? (m_zone.nextCenter - m_zone.currentCenter) * (1 / ticks) : Vec2{};
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+#include "model/Constants.hpp"
+#include "model/Game.hpp"
+#include "world/ObstacleIndex.h"
+
+/**
+ * Seeded generator of valid games at any scale, for benchmarks and load tests.
+ *
+ * The world is simulated tick by tick, so consecutive games are consistent with each other:
+ * obstacles don't overlap, units move through free space and stay in the zone, projectiles fly
+ * at their weapon's speed and are replaced when their lifetime runs out or they hit an obstacle
+ * they can't pass, and the zone shrinks by `zoneSpeed` towards its next circle. The same settings
+ * always produce the same games. Games only hold the enemies in view, which are all of them unless
+ * `visibilityPeriod` hides some.
+ */
+class GameGenerator
+{
+public:
+    struct Settings
+    {
+        uint32_t seed = 1;
+        int units = 2;
+        int teamSize = 1;
+        int projectiles = 0;
+        int obstacles = 150;
+        double zoneRadius = 300;
+        // units spawn within this distance of the zone center, the whole zone if not positive
+        double spawnRadius = 0;
+        // every enemy is out of view for the second half of every period of this many ticks,
+        // staggered by id, always in view if not positive
+        int visibilityPeriod = 0;
+    };
+
+    /**
+     * @throw std::runtime_error if the obstacles or units don't fit into the zone.
+     */
+    explicit GameGenerator(const Settings &settings);
+
+    const model::Constants &constants() const { return m_constants; }
+    /**
+     * @return Game of the current tick, then advances the world by one tick.
+     */
+    model::Game next();
+
+private:
+    model::Constants makeConstants();
+    std::vector<model::Obstacle> makeObstacles();
+    void placeUnits();
+    model::Projectile makeProjectile(bool inFlight);
+    model::Vec2 randomPoint(double radius);
+    bool isFree(const model::Vec2 &position, double radius, bool shot) const;
+
+    void moveUnits();
+    void moveProjectiles();
+    void moveZone();
+    void nextZonePhase();
+
+private:
+    const Settings m_settings;
+    std::mt19937 m_random;
+    model::Constants m_constants;
+    ObstacleIndex m_obstacleIndex;
+
+    int m_tick = 0;
+    int m_nextProjectileId = 0;
+    std::pmr::vector<model::Unit> m_units;
+    // heading of every unit in m_units, in radians
+    std::vector<double> m_headings;
+    std::pmr::vector<model::Projectile> m_projectiles;
+    model::Zone m_zone;
+    // zone center movement per tick during the current phase
+    model::Vec2 m_zoneVelocity;
+
+    mutable std::vector<int> m_obstacles;
+};
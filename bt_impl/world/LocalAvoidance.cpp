@@ -0,0 +1,266 @@
+#include "LocalAvoidance.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace model;
+
+constexpr auto TIME_HORIZON = 1.0; // seconds
+constexpr auto TEAMMATE_RESPONSIBILITY = 0.5;
+constexpr auto EPSILON = 1e-9;
+
+namespace {
+
+double det(const Vec2 &v1, const Vec2 &v2)
+{
+    return v1.x * v2.y - v1.y * v2.x;
+}
+
+} // namespace
+
+LocalAvoidance::LocalAvoidance(const DerivedConstants &constants,
+                               const ObstacleIndex &obstacleIndex)
+    : m_constants{constants.constants()},
+      m_derived{constants},
+      m_obstacleIndex{obstacleIndex},
+      m_maxSpeed{(m_constants.maxUnitForwardSpeed + m_constants.maxUnitBackwardSpeed) / 2}
+{}
+
+Vec2 LocalAvoidance::filter(const Game &game, const Unit &unit, const Vec2 &preferredVelocity)
+{
+    m_lines.clear();
+    m_obstacles.clear();
+
+    const auto reach = m_constants.maxUnitForwardSpeed * TIME_HORIZON;
+    m_obstacleIndex.query(unit.position, reach + m_constants.unitRadius, m_obstacles);
+    for (const auto index : m_obstacles) {
+        const auto &obstacle = m_constants.obstacles[index];
+        addLine(unit,
+                obstacle.position - unit.position,
+                Vec2{},
+                m_derived.inflatedObstacleRadius(index),
+                TIME_HORIZON,
+                1);
+    }
+    const auto obstacleLines = m_lines.size();
+
+    // the cull reads only the positions of the unit table, the few units in range the rest
+    const auto &units = game.unitTable;
+    const auto range = 2 * (reach + m_constants.unitRadius);
+    for (size_t i = 0; i < units.size(); ++i) {
+        const auto relativePosition = units.position[i] - unit.position;
+        if (relativePosition.sqrLength() > range * range || units.id[i] == unit.id
+            || !units.spawned[i]) {
+            continue;
+        }
+
+        addLine(unit,
+                relativePosition,
+                units.velocity[i],
+                2 * m_constants.unitRadius,
+                TIME_HORIZON,
+                units.playerId[i] == unit.playerId ? TEAMMATE_RESPONSIBILITY : 1);
+    }
+
+    for (const auto &projectile : game.projectiles) {
+        if (projectile.shooterPlayerId == unit.playerId)
+            continue;
+
+        const auto relativePosition = projectile.position - unit.position;
+        const auto timeHorizon = min(TIME_HORIZON, projectile.lifeTime);
+        const auto range = (projectile.velocity.length() + m_constants.maxUnitForwardSpeed) * timeHorizon
+                           + m_constants.unitRadius;
+        if (timeHorizon <= 0 || dotProduct(relativePosition, projectile.velocity) >= 0
+            || relativePosition.sqrLength() > range * range) {
+            continue;
+        }
+
+        addLine(unit, relativePosition, projectile.velocity, m_constants.unitRadius, timeHorizon, 1);
+    }
+
+    // solve around the center of the speed limit disc
+    const auto center = unit.direction
+                        * ((m_constants.maxUnitForwardSpeed - m_constants.maxUnitBackwardSpeed) / 2);
+    for (auto &line : m_lines)
+        line.point = line.point - center;
+
+    Vec2 result;
+    const auto optVelocity = preferredVelocity - center;
+    const auto lineFail = linearProgram2(m_lines, optVelocity, false, result);
+    if (lineFail < m_lines.size())
+        linearProgram3(obstacleLines, lineFail, result);
+
+    return result + center;
+}
+
+void LocalAvoidance::addLine(const Unit &unit,
+                             const Vec2 &relativePosition,
+                             const Vec2 &otherVelocity,
+                             double combinedRadius,
+                             double timeHorizon,
+                             double responsibility)
+{
+    const auto relativeVelocity = unit.velocity - otherVelocity;
+    const auto distSq = relativePosition.sqrLength();
+    const auto combinedRadiusSq = combinedRadius * combinedRadius;
+
+    Line line;
+    Vec2 u;
+    if (distSq > combinedRadiusSq) {
+        // vector from cutoff center to relative velocity
+        const auto w = relativeVelocity - relativePosition * (1 / timeHorizon);
+        const auto wLengthSq = w.sqrLength();
+        const auto dotProduct1 = dotProduct(w, relativePosition);
+
+        if (dotProduct1 < 0 && dotProduct1 * dotProduct1 > combinedRadiusSq * wLengthSq) {
+            // project on cut-off circle
+            const auto wLength = sqrt(wLengthSq);
+            const auto unitW = w * (1 / wLength);
+            line.direction = Vec2{unitW.y, -unitW.x};
+            u = unitW * (combinedRadius / timeHorizon - wLength);
+        } else {
+            // project on legs
+            const auto leg = sqrt(distSq - combinedRadiusSq);
+            if (det(relativePosition, w) > 0) {
+                line.direction = Vec2{relativePosition.x * leg - relativePosition.y * combinedRadius,
+                                      relativePosition.x * combinedRadius + relativePosition.y * leg}
+                                 * (1 / distSq);
+            } else {
+                line.direction = Vec2{relativePosition.x * leg + relativePosition.y * combinedRadius,
+                                      -relativePosition.x * combinedRadius + relativePosition.y * leg}
+                                 * (-1 / distSq);
+            }
+            u = line.direction * dotProduct(relativeVelocity, line.direction) - relativeVelocity;
+        }
+    } else {
+        // already colliding: project on cut-off circle of one tick
+        const auto invTimeStep = m_constants.ticksPerSecond;
+        const auto w = relativeVelocity - relativePosition * invTimeStep;
+        const auto wLength = w.length();
+        if (wLength < EPSILON)
+            return;
+
+        const auto unitW = w * (1 / wLength);
+        line.direction = Vec2{unitW.y, -unitW.x};
+        u = unitW * (combinedRadius * invTimeStep - wLength);
+    }
+
+    line.point = unit.velocity + u * responsibility;
+    m_lines.push_back(line);
+}
+
+bool LocalAvoidance::linearProgram1(const vector<Line> &lines,
+                                    size_t lineNo,
+                                    const Vec2 &optVelocity,
+                                    bool directionOpt,
+                                    Vec2 &result) const
+{
+    const auto &line = lines[lineNo];
+    const auto dot = dotProduct(line.point, line.direction);
+    const auto discriminant = dot * dot + m_maxSpeed * m_maxSpeed - line.point.sqrLength();
+    if (discriminant < 0) {
+        // max speed circle fully invalidates line
+        return false;
+    }
+
+    const auto sqrtDiscriminant = sqrt(discriminant);
+    auto tLeft = -dot - sqrtDiscriminant;
+    auto tRight = -dot + sqrtDiscriminant;
+
+    for (size_t i = 0; i < lineNo; ++i) {
+        const auto denominator = det(line.direction, lines[i].direction);
+        const auto numerator = det(lines[i].direction, line.point - lines[i].point);
+
+        if (abs(denominator) <= EPSILON) {
+            // lines are parallel
+            if (numerator < 0)
+                return false;
+            continue;
+        }
+
+        const auto t = numerator / denominator;
+        if (denominator >= 0)
+            tRight = min(tRight, t);
+        else
+            tLeft = max(tLeft, t);
+
+        if (tLeft > tRight)
+            return false;
+    }
+
+    if (directionOpt) {
+        result = line.point + line.direction * (dotProduct(optVelocity, line.direction) > 0 ? tRight
+                                                                                          : tLeft);
+    } else {
+        const auto t = clamp(dotProduct(line.direction, optVelocity - line.point), tLeft, tRight);
+        result = line.point + line.direction * t;
+    }
+    return true;
+}
+
+size_t LocalAvoidance::linearProgram2(const vector<Line> &lines,
+                                      const Vec2 &optVelocity,
+                                      bool directionOpt,
+                                      Vec2 &result) const
+{
+    if (directionOpt) {
+        // optVelocity is a unit direction here
+        result = optVelocity * m_maxSpeed;
+    } else if (optVelocity.sqrLength() > m_maxSpeed * m_maxSpeed) {
+        result = normalizeVelocity(optVelocity, m_maxSpeed);
+    } else {
+        result = optVelocity;
+    }
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (det(lines[i].direction, lines[i].point - result) > 0) {
+            // result doesn't satisfy constraint i, compute new optimal result
+            const auto tempResult = result;
+            if (!linearProgram1(lines, i, optVelocity, directionOpt, result)) {
+                result = tempResult;
+                return i;
+            }
+        }
+    }
+    return lines.size();
+}
+
+void LocalAvoidance::linearProgram3(size_t obstacleLines, size_t beginLine, Vec2 &result)
+{
+    auto distance = 0.0;
+    for (auto i = beginLine; i < m_lines.size(); ++i) {
+        const auto &line = m_lines[i];
+        if (det(line.direction, line.point - result) <= distance)
+            continue;
+
+        // result doesn't satisfy constraint of line i
+        m_projectedLines.assign(cbegin(m_lines), cbegin(m_lines) + obstacleLines);
+        for (auto j = obstacleLines; j < i; ++j) {
+            Line projected;
+            const auto determinant = det(line.direction, m_lines[j].direction);
+            if (abs(determinant) <= EPSILON) {
+                if (dotProduct(line.direction, m_lines[j].direction) > 0) {
+                    // lines point in the same direction
+                    continue;
+                }
+                projected.point = (line.point + m_lines[j].point) * 0.5;
+            } else {
+                projected.point = line.point
+                                  + line.direction
+                                        * (det(m_lines[j].direction, line.point - m_lines[j].point)
+                                           / determinant);
+            }
+            projected.direction = (m_lines[j].direction - line.direction).normalize();
+            m_projectedLines.push_back(projected);
+        }
+
+        const auto tempResult = result;
+        if (linearProgram2(m_projectedLines, Vec2{-line.direction.y, line.direction.x}, true, result)
+            < m_projectedLines.size()) {
+            // can only happen due to floating point error, keep the previous result
+            result = tempResult;
+        }
+        distance = det(line.direction, line.point - result);
+    }
+}
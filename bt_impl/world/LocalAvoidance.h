@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include "model/Game.hpp"
+#include "world/DerivedConstants.h"
+#include "world/ObstacleIndex.h"
+
+/**
+ * ORCA local collision avoidance, applied as the last filter on a unit's target velocity.
+ *
+ * Obstacles, visible units and enemy projectiles each contribute one half-plane of permitted
+ * velocities over `TIME_HORIZON`. Teammates take half of the avoidance responsibility, everything
+ * else is assumed not to cooperate. The closest velocity to the preferred one satisfying all
+ * half-planes is found with the incremental 2D linear program from RVO2, inside the game's
+ * speed limit: a disc of diameter `maxUnitForwardSpeed + maxUnitBackwardSpeed` shifted along the
+ * unit's direction. If the constraints are infeasible, the velocity minimizing the largest
+ * violation of the soft (non obstacle) constraints is returned.
+ */
+class LocalAvoidance
+{
+public:
+    LocalAvoidance(const DerivedConstants &constants, const ObstacleIndex &obstacleIndex);
+
+    model::Vec2 filter(const model::Game &game,
+                       const model::Unit &unit,
+                       const model::Vec2 &preferredVelocity);
+
+private:
+    struct Line
+    {
+        model::Vec2 point;
+        model::Vec2 direction;
+    };
+
+    void addLine(const model::Unit &unit,
+                 const model::Vec2 &relativePosition,
+                 const model::Vec2 &otherVelocity,
+                 double combinedRadius,
+                 double timeHorizon,
+                 double responsibility);
+
+    bool linearProgram1(const std::vector<Line> &lines,
+                        size_t lineNo,
+                        const model::Vec2 &optVelocity,
+                        bool directionOpt,
+                        model::Vec2 &result) const;
+    size_t linearProgram2(const std::vector<Line> &lines,
+                          const model::Vec2 &optVelocity,
+                          bool directionOpt,
+                          model::Vec2 &result) const;
+    void linearProgram3(size_t obstacleLines, size_t beginLine, model::Vec2 &result);
+
+private:
+    const model::Constants &m_constants;
+    const DerivedConstants &m_derived;
+    const ObstacleIndex &m_obstacleIndex;
+    const double m_maxSpeed;
+
+    // reused between calls so filtering doesn't allocate in steady state
+    std::vector<int> m_obstacles;
+    std::vector<Line> m_lines;
+    std::vector<Line> m_projectedLines;
+};
@@ -0,0 +1,53 @@
+#include "ObstacleIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace std;
+using namespace model;
+
+ObstacleIndex::ObstacleIndex(const Constants &constants, double cellSize)
+    : m_constants{constants},
+      m_cellSize{cellSize},
+      m_origin{-constants.initialZoneRadius},
+      m_size{max(1, static_cast<int>(ceil(2 * constants.initialZoneRadius / cellSize)))},
+      m_offsets(m_size * m_size + 1)
+{
+    const auto &obstacles = m_constants.obstacles;
+    const auto cellOf = [this](const Obstacle &obstacle) {
+        return cell(obstacle.position.y) * m_size + cell(obstacle.position.x);
+    };
+
+    // counting sort of obstacles by cell
+    for (const auto &obstacle : obstacles) {
+        ++m_offsets[cellOf(obstacle) + 1];
+        m_maxRadius = max(m_maxRadius, obstacle.radius);
+    }
+    partial_sum(begin(m_offsets), end(m_offsets), begin(m_offsets));
+
+    m_indices.resize(obstacles.size());
+    auto fill = vector<int>(cbegin(m_offsets), cend(m_offsets) - 1);
+    for (int i = 0; i < static_cast<int>(obstacles.size()); ++i)
+        m_indices[fill[cellOf(obstacles[i])]++] = i;
+}
+
+void ObstacleIndex::query(const Vec2 &center, double radius, vector<int> &result) const
+{
+    const auto reach = radius + m_maxRadius;
+    const auto c0 = cell(center.x - reach);
+    const auto c1 = cell(center.x + reach);
+    for (int r = cell(center.y - reach); r <= cell(center.y + reach); ++r) {
+        for (auto i = m_offsets[r * m_size + c0]; i < m_offsets[r * m_size + c1 + 1]; ++i) {
+            const auto &obstacle = m_constants.obstacles[m_indices[i]];
+            const auto distance = radius + obstacle.radius;
+            if ((obstacle.position - center).sqrLength() <= distance * distance)
+                result.push_back(m_indices[i]);
+        }
+    }
+}
+
+int ObstacleIndex::cell(double coordinate) const
+{
+    return clamp(static_cast<int>(floor((coordinate - m_origin) / m_cellSize)), 0, m_size - 1);
+}
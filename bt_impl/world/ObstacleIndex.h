@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+
+#include "model/Constants.hpp"
+
+/**
+ * Uniform grid over `Constants::obstacles`, built once per game.
+ *
+ * Every obstacle is bucketed by its center only, queries widen the searched cells by the largest
+ * obstacle radius. Buckets are stored contiguously (offsets + indices), so a query touches a
+ * handful of small arrays and never allocates if the output vector has enough capacity.
+ */
+class ObstacleIndex
+{
+public:
+    ObstacleIndex(const model::Constants &constants, double cellSize = 8.0);
+
+    /**
+     * Appends indices into `Constants::obstacles` of all obstacles intersecting the circle.
+     */
+    void query(const model::Vec2 &center, double radius, std::vector<int> &result) const;
+
+    double maxObstacleRadius() const { return m_maxRadius; }
+
+private:
+    int cell(double coordinate) const;
+
+private:
+    const model::Constants &m_constants;
+    const double m_cellSize;
+    const double m_origin;
+    const int m_size;
+    double m_maxRadius = 0;
+
+    // obstacles of cell i are m_indices[m_offsets[i] .. m_offsets[i + 1])
+    std::vector<int> m_offsets;
+    std::vector<int> m_indices;
+};
@@ -0,0 +1,77 @@
+#include "StrategyParameters.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+constexpr pair<string_view, double StrategyParameters::*> PARAMETERS[] = {
+    {"cos_threshold", &StrategyParameters::cosThreshold},
+    {"shoot_range_ratio", &StrategyParameters::shootRangeRatio},
+    {"zone_padding", &StrategyParameters::zonePadding},
+};
+
+string_view trim(string_view text)
+{
+    constexpr auto SPACE = " \t\r";
+    text.remove_prefix(min(text.find_first_not_of(SPACE), text.size()));
+    text.remove_suffix(text.size() - min(text.find_last_not_of(SPACE) + 1, text.size()));
+    return text;
+}
+
+} // namespace
+
+void StrategyParameters::set(string_view name, string_view value)
+{
+    name = trim(name);
+    value = trim(value);
+    const auto it = find_if(begin(PARAMETERS), end(PARAMETERS), [&](const auto &parameter) {
+        return parameter.first == name;
+    });
+    if (it == end(PARAMETERS))
+        throw runtime_error("unknown strategy parameter: " + string{name});
+
+    double number = 0;
+    const auto [last, error] = from_chars(value.data(), value.data() + value.size(), number);
+    if (value.empty() || error != errc{} || last != value.data() + value.size())
+        throw runtime_error("strategy parameter " + string{name} + " isn't a number: "
+                            + string{value});
+    this->*it->second = number;
+}
+
+void StrategyParameters::set(string_view assignment)
+{
+    const auto separator = assignment.find('=');
+    if (separator == string_view::npos)
+        throw runtime_error("expected name=value: " + string{assignment});
+    set(assignment.substr(0, separator), assignment.substr(separator + 1));
+}
+
+void StrategyParameters::load(const filesystem::path &path)
+{
+    ifstream file{path};
+    if (!file)
+        throw runtime_error("can't read strategy parameters from " + path.string());
+
+    for (string line; getline(file, line);) {
+        const auto content = trim(string_view{line}.substr(0, line.find('#')));
+        if (!content.empty())
+            set(content);
+    }
+}
+
+void StrategyParameters::write(ostream &stream) const
+{
+    // the shortest text from_chars reads back to the same value
+    char value[32];
+    for (const auto &[name, parameter] : PARAMETERS) {
+        const auto last = to_chars(begin(value), end(value), this->*parameter).ptr;
+        stream << name << " = " << string_view{value, static_cast<size_t>(last - value)} << '\n';
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <filesystem>
+#include <ostream>
+#include <string_view>
+
+/**
+ * Tunable numbers of the strategy, fixed for a game. The defaults are the hand tuned values, a
+ * file or the command line may override any of them by name.
+ */
+struct StrategyParameters
+{
+    // Look succeeds once the cosine between the unit's and the wanted direction is above this
+    double cosThreshold = 0.99;
+    // GoToTarget stops once the target is within this fraction of the weapon range
+    double shootRangeRatio = 2.0 / 3.0;
+    // distance from the zone edge AvoidZone keeps, in addition to the unit radius
+    double zonePadding = 0.5;
+
+    /**
+     * Sets the parameter called @p name (cos_threshold, shoot_range_ratio, zone_padding).
+     *
+     * @throws std::runtime_error on an unknown name or a value that isn't a number.
+     */
+    void set(std::string_view name, std::string_view value);
+    /**
+     * Sets `name=value`, as given on the command line.
+     */
+    void set(std::string_view assignment);
+    /**
+     * Sets the parameters of @p path, one `name = value` per line, `#` starts a comment.
+     *
+     * @throws std::runtime_error if the file can't be read or has an invalid line.
+     */
+    void load(const std::filesystem::path &path);
+    /**
+     * Writes every parameter as `name = value` per line, in the format `load` reads.
+     */
+    void write(std::ostream &stream) const;
+};
@@ -0,0 +1,127 @@
+#include "TargetScorer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace std;
+using namespace model;
+
+constexpr auto LINE_OF_FIRE_WEIGHT = 2.0f;
+constexpr auto AIMING_WEIGHT = 1.0f;
+constexpr auto TIME_TO_KILL_WEIGHT = 1.0f; // per second
+constexpr auto UNARMED_TIME_TO_KILL = 1000.0f; // seconds
+
+TargetScorer::TargetScorer(const DerivedConstants &constants, const ObstacleIndex &obstacleIndex)
+    : m_constants{constants.constants()}, m_derived{constants}, m_obstacleIndex{obstacleIndex}
+{}
+
+const vector<int> &TargetScorer::rank(const Game &game, const Unit &unit)
+{
+    gather(game, unit);
+    score(unit);
+
+    m_order.resize(m_ids.size());
+    iota(begin(m_order), end(m_order), 0);
+    sort(begin(m_order), end(m_order), [this](int left, int right) {
+        return m_score[left] > m_score[right];
+    });
+
+    m_ranked.clear();
+    for (const auto index : m_order)
+        m_ranked.push_back(m_ids[index]);
+    return m_ranked;
+}
+
+void TargetScorer::gather(const Game &game, const Unit &unit)
+{
+    m_ids.clear();
+    m_effectiveHealth.clear();
+    m_distance.clear();
+    m_lineOfFire.clear();
+    m_armed.clear();
+    m_aimingAtUs.clear();
+
+    const auto cosHalfFov = m_derived.cosHalfFieldOfView();
+    const auto &units = game.unitTable;
+    for (size_t i = 0; i < units.size(); ++i) {
+        if (units.playerId[i] == unit.playerId || !units.spawned[i])
+            continue;
+
+        const auto toUs = unit.position - units.position[i];
+        const auto distance = toUs.length();
+        const auto aiming = distance > 0
+                            && dotProduct(units.direction[i], toUs) > cosHalfFov * distance;
+
+        m_ids.push_back(units.id[i]);
+        m_effectiveHealth.push_back(static_cast<float>(units.health[i] + units.shield[i]));
+        m_distance.push_back(static_cast<float>(distance));
+        m_lineOfFire.push_back(lineOfFire(unit.position, units.position[i]) ? 1.0f : 0.0f);
+        m_armed.push_back(units.weapon[i] >= 0 ? 1.0f : 0.0f);
+        m_aimingAtUs.push_back(aiming ? 1.0f : 0.0f);
+    }
+}
+
+void TargetScorer::score(const Unit &unit)
+{
+    const auto count = m_ids.size();
+    m_timeToKill.resize(count);
+    m_score.resize(count);
+
+    if (!unit.weapon) {
+        fill(begin(m_timeToKill), end(m_timeToKill), UNARMED_TIME_TO_KILL);
+    } else {
+        const auto &weapon = m_constants.weapons.at(unit.weapon.value());
+        const auto damage = static_cast<float>(weapon.projectileDamage);
+        const auto fireInterval = static_cast<float>(1 / weapon.roundsPerSecond);
+        const auto aimTime = static_cast<float>(weapon.aimTime);
+        const auto projectileSpeed = static_cast<float>(weapon.projectileSpeed);
+        const auto range = static_cast<float>(m_derived.weapon(unit.weapon.value()).range);
+        const auto moveSpeed = static_cast<float>(m_constants.maxUnitForwardSpeed);
+
+        const auto *health = m_effectiveHealth.data();
+        const auto *distance = m_distance.data();
+        auto *timeToKill = m_timeToKill.data();
+        for (size_t i = 0; i < count; ++i) {
+            // ceil of a non-negative value without a libm call, which SSE2 has no instruction for
+            const auto exactShots = health[i] / damage;
+            const auto wholeShots = static_cast<float>(static_cast<int>(exactShots));
+            const auto shots = wholeShots + (wholeShots < exactShots ? 1.0f : 0.0f);
+            const auto approach = max(distance[i] - range, 0.0f) / moveSpeed;
+            const auto flight = min(distance[i], range) / projectileSpeed;
+            timeToKill[i] = approach + aimTime + (shots - 1) * fireInterval + flight;
+        }
+    }
+
+    const auto *lineOfFire = m_lineOfFire.data();
+    const auto *armed = m_armed.data();
+    const auto *aimingAtUs = m_aimingAtUs.data();
+    const auto *timeToKill = m_timeToKill.data();
+    auto *result = m_score.data();
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = LINE_OF_FIRE_WEIGHT * lineOfFire[i] + AIMING_WEIGHT * armed[i] * aimingAtUs[i]
+                    - TIME_TO_KILL_WEIGHT * timeToKill[i];
+    }
+}
+
+bool TargetScorer::lineOfFire(const Vec2 &from, const Vec2 &to)
+{
+    const auto segment = to - from;
+    const auto length = segment.length();
+    if (length <= 0)
+        return true;
+
+    m_obstacles.clear();
+    m_obstacleIndex.query(from + segment * 0.5, length / 2, m_obstacles);
+
+    const auto direction = segment * (1 / length);
+    return none_of(cbegin(m_obstacles), cend(m_obstacles), [&](int index) {
+        const auto &obstacle = m_constants.obstacles[index];
+        if (obstacle.canShootThrough)
+            return false;
+
+        const auto t = clamp(dotProduct(obstacle.position - from, direction), 0.0, length);
+        const auto closest = from + direction * t;
+        return (obstacle.position - closest).sqrLength() < obstacle.radius * obstacle.radius;
+    });
+}
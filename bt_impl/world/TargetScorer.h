@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "model/Game.hpp"
+#include "world/DerivedConstants.h"
+#include "world/ObstacleIndex.h"
+
+/**
+ * Utility scoring of every visible enemy as a target for a unit.
+ *
+ * Features are gathered into one array per feature (health + shield, distance, line of fire,
+ * armed, aiming at us), then the expected time-to-kill with the unit's weapon and the final
+ * score are computed in a single branch-free pass over the arrays, which the compiler
+ * vectorizes.
+ */
+class TargetScorer
+{
+public:
+    TargetScorer(const DerivedConstants &constants, const ObstacleIndex &obstacleIndex);
+
+    /**
+     * @return Ids of enemies of @p unit ordered from the best target to the worst.
+     */
+    const std::vector<int> &rank(const model::Game &game, const model::Unit &unit);
+
+private:
+    void gather(const model::Game &game, const model::Unit &unit);
+    void score(const model::Unit &unit);
+    bool lineOfFire(const model::Vec2 &from, const model::Vec2 &to);
+
+private:
+    const model::Constants &m_constants;
+    const DerivedConstants &m_derived;
+    const ObstacleIndex &m_obstacleIndex;
+
+    std::vector<int> m_ids;
+    std::vector<float> m_effectiveHealth;
+    std::vector<float> m_distance;
+    std::vector<float> m_lineOfFire;
+    std::vector<float> m_armed;
+    std::vector<float> m_aimingAtUs;
+    std::vector<float> m_timeToKill;
+    std::vector<float> m_score;
+
+    std::vector<int> m_order;
+    std::vector<int> m_ranked;
+    std::vector<int> m_obstacles;
+};
@@ -0,0 +1,78 @@
+#include "WorldFacts.h"
+
+using namespace std;
+using namespace model;
+
+// closer enemies are on top of the unit and have no direction
+constexpr auto MIN_ENEMY_DISTANCE = 1e-6;
+
+WorldFacts::WorldFacts(const DerivedConstants &constants,
+                       const Game &game,
+                       const Unit &unit,
+                       const EnemyMap &enemies)
+    : m_constants{constants.constants()}, m_derived{constants}, m_game{game}, m_unit{unit},
+      m_enemies{enemies}
+{}
+
+void WorldFacts::invalidate()
+{
+    ++m_generation;
+    for (auto it = begin(m_enemyFacts); it != end(m_enemyFacts);) {
+        const auto current = it++;
+        if (!m_enemies.contains(current->first))
+            m_spareEnemyFacts.push_back(m_enemyFacts.extract(current));
+    }
+}
+
+optional<double> WorldFacts::weaponRange() const
+{
+    if (!m_unit.weapon)
+        return nullopt;
+    return m_derived.weapon(m_unit.weapon.value()).range;
+}
+
+const Vec2 &WorldFacts::toZoneCenter()
+{
+    return m_toZoneCenter.get(m_generation,
+                              [this] { return m_game.zone.currentCenter - m_unit.position; });
+}
+
+double WorldFacts::zoneCenterDistance()
+{
+    return m_zoneCenterDistance.get(m_generation, [this] { return toZoneCenter().length(); });
+}
+
+const Vec2 &WorldFacts::toEnemy(int id)
+{
+    return enemyFacts(id).toEnemy.get(m_generation, [this, id] {
+        return m_enemies.at(id).unit.get().position - m_unit.position;
+    });
+}
+
+double WorldFacts::enemyDistance(int id)
+{
+    return enemyFacts(id).distance.get(m_generation, [this, id] { return toEnemy(id).length(); });
+}
+
+const Vec2 &WorldFacts::enemyDirection(int id)
+{
+    return enemyFacts(id).direction.get(m_generation, [this, id] {
+        const auto distance = enemyDistance(id);
+        return distance < MIN_ENEMY_DISTANCE ? m_unit.direction.normalize()
+                                             : toEnemy(id) * (1 / distance);
+    });
+}
+
+WorldFacts::EnemyFacts &WorldFacts::enemyFacts(int id)
+{
+    if (const auto it = m_enemyFacts.find(id); it != end(m_enemyFacts))
+        return it->second;
+    if (m_spareEnemyFacts.empty())
+        return m_enemyFacts[id];
+
+    auto node = move(m_spareEnemyFacts.back());
+    m_spareEnemyFacts.pop_back();
+    node.key() = id;
+    node.mapped() = {};
+    return m_enemyFacts.insert(move(node)).position->second;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "model/Game.hpp"
+#include "world/DerivedConstants.h"
+
+/**
+ * Lazily evaluated facts about the world, shared by all behavior nodes.
+ *
+ * Every fact is computed on first request and reused until `invalidate()` is called at the start
+ * of the next tick, so re-ticked reactive nodes don't repeat the same work. Invalidation bumps a
+ * generation counter and drops the facts of enemies no longer seen, keeping their memory for the
+ * next ones.
+ */
+class WorldFacts
+{
+public:
+    WorldFacts(const DerivedConstants &constants,
+               const model::Game &game,
+               const model::Unit &unit,
+               const EnemyMap &enemies);
+
+    void invalidate();
+
+    /**
+     * @return Distance our projectiles fly, or nothing if the unit has no weapon.
+     */
+    std::optional<double> weaponRange() const;
+    const model::Vec2 &toZoneCenter();
+    double zoneCenterDistance();
+
+    const model::Vec2 &toEnemy(int id);
+    double enemyDistance(int id);
+    /**
+     * @return Unit vector to the enemy, the unit's direction if the enemy is on top of it.
+     */
+    const model::Vec2 &enemyDirection(int id);
+
+private:
+    template<typename T>
+    class Fact
+    {
+    public:
+        template<typename Compute>
+        const T &get(unsigned generation, Compute &&compute)
+        {
+            if (m_generation != generation) {
+                m_value = compute();
+                m_generation = generation;
+            }
+            return m_value;
+        }
+
+    private:
+        T m_value{};
+        unsigned m_generation = 0;
+    };
+
+    struct EnemyFacts
+    {
+        Fact<model::Vec2> toEnemy;
+        Fact<double> distance;
+        Fact<model::Vec2> direction;
+    };
+
+    EnemyFacts &enemyFacts(int id);
+
+private:
+    const model::Constants &m_constants;
+    const DerivedConstants &m_derived;
+    const model::Game &m_game;
+    const model::Unit &m_unit;
+    const EnemyMap &m_enemies;
+
+    unsigned m_generation = 1;
+    Fact<model::Vec2> m_toZoneCenter;
+    Fact<double> m_zoneCenterDistance;
+    std::unordered_map<int, EnemyFacts> m_enemyFacts;
+    std::vector<std::unordered_map<int, EnemyFacts>::node_type> m_spareEnemyFacts;
+};
@@ -0,0 +1,113 @@
+#include "ZonePredictor.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+using namespace std;
+using namespace model;
+
+ZonePredictor::ZonePredictor(const DerivedConstants &constants)
+    : m_constants{constants.constants()}, m_radiusSpeed{constants.zoneRadiusPerTick()}
+{}
+
+void ZonePredictor::update(const Zone &zone, int currentTick)
+{
+    m_currentTick = currentTick;
+    if (zone.nextCenter == m_nextCenter && realNearlyEqual(zone.nextRadius, m_nextRadius))
+        return;
+
+    m_nextCenter = zone.nextCenter;
+    m_nextRadius = zone.nextRadius;
+    m_phaseStartTick = currentTick;
+    m_startCenter = zone.currentCenter;
+    m_startRadius = zone.currentRadius;
+    m_phaseTicks = m_radiusSpeed > 0 ? max(0.0, zone.currentRadius - zone.nextRadius) / m_radiusSpeed
+                                     : 0;
+    m_centerVelocity = m_phaseTicks > 0 ? (zone.nextCenter - zone.currentCenter) * (1 / m_phaseTicks)
+                                        : Vec2{};
+}
+
+double ZonePredictor::radius(int tick) const
+{
+    const auto elapsed = max(0, tick - m_phaseStartTick);
+    return max(0.0, m_startRadius - m_radiusSpeed * elapsed);
+}
+
+Vec2 ZonePredictor::center(int tick) const
+{
+    const auto elapsed = clamp(static_cast<double>(tick - m_phaseStartTick), 0.0, m_phaseTicks);
+    return m_startCenter + m_centerVelocity * elapsed;
+}
+
+int ZonePredictor::phaseEndTick() const
+{
+    return m_phaseStartTick + static_cast<int>(ceil(m_phaseTicks));
+}
+
+int ZonePredictor::lastRespawnTick() const
+{
+    if (m_radiusSpeed <= 0)
+        return INT_MAX;
+
+    const auto ticks = (m_startRadius - m_constants.lastRespawnZoneRadius) / m_radiusSpeed;
+    return m_phaseStartTick + max(0, static_cast<int>(ceil(ticks)));
+}
+
+int ZonePredictor::ticksUntilOutside(const Vec2 &point, double margin) const
+{
+    if (m_radiusSpeed <= 0)
+        return INT_MAX;
+
+    // within the phase: solve |point - c(t)| = r(t) - margin for the smallest t >= 0,
+    // with c(t) = c0 + cv * t and r(t) = r0 - v * t relative to the phase start
+    const auto w = point - m_startCenter;
+    const auto r0 = m_startRadius - margin;
+    const auto v = m_radiusSpeed;
+    const auto elapsed = static_cast<double>(m_currentTick - m_phaseStartTick);
+
+    auto hitTick = -1.0;
+    if (elapsed <= m_phaseTicks) {
+        const auto a = m_centerVelocity.sqrLength() - v * v;
+        const auto b = 2 * (r0 * v - dotProduct(w, m_centerVelocity));
+        const auto c = w.sqrLength() - r0 * r0;
+        if (c >= 0) {
+            hitTick = 0;
+        } else if (abs(a) < 1e-12) {
+            hitTick = b != 0 ? -c / b : -1;
+        } else {
+            // center moves slower than the edge, so a < 0 and the smaller root is the first crossing
+            const auto discriminant = b * b - 4 * a * c;
+            if (discriminant >= 0)
+                hitTick = (-b + sqrt(discriminant)) / (2 * a);
+        }
+        if (hitTick > m_phaseTicks)
+            hitTick = -1;
+    }
+
+    if (hitTick < 0) {
+        // after the phase the zone shrinks around the next center
+        const auto distance = (point - m_nextCenter).length();
+        hitTick = m_phaseTicks + max(0.0, m_nextRadius - margin - distance) / v;
+    }
+
+    return max(0, static_cast<int>(floor(hitTick - elapsed)));
+}
+
+int ZonePredictor::latestDepartureTick(const Vec2 &point, double speed, double margin) const
+{
+    const auto untilOutside = ticksUntilOutside(point, margin);
+    const auto unitSpeed = speed / m_constants.ticksPerSecond;
+    if (unitSpeed <= m_radiusSpeed + m_centerVelocity.length())
+        return untilOutside == INT_MAX ? INT_MAX : m_currentTick;
+
+    const auto untilOutsideTick = untilOutside == INT_MAX ? INT_MAX : m_currentTick + untilOutside;
+    const auto toTravel = (point - m_nextCenter).length() - (m_nextRadius - margin);
+    if (toTravel <= 0)
+        return untilOutsideTick;
+
+    // a unit faster than the edge is never caught once it moves inwards, it only has to be inside
+    // the next zone by the time the phase ends
+    const auto phaseDeadline = phaseEndTick() - static_cast<int>(ceil(toTravel / unitSpeed));
+    return max(m_currentTick, min(untilOutsideTick, phaseDeadline));
+}
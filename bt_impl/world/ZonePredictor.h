@@ -0,0 +1,56 @@
+#pragma once
+
+#include "model/Constants.hpp"
+#include "model/Zone.hpp"
+#include "world/DerivedConstants.h"
+
+/**
+ * Predicts the zone timeline from the current phase.
+ *
+ * During a phase the radius shrinks by `zoneSpeed` and the center moves linearly so that both
+ * reach `nextCenter/nextRadius` at the same tick. Past the phase the next target is unknown, so
+ * the zone is assumed to keep shrinking around `nextCenter` at the same speed.
+ *
+ * The phase is precomputed once when `nextCenter/nextRadius` change, all queries are O(1).
+ */
+class ZonePredictor
+{
+public:
+    ZonePredictor(const DerivedConstants &constants);
+
+    void update(const model::Zone &zone, int currentTick);
+
+    double radius(int tick) const;
+    model::Vec2 center(int tick) const;
+    int phaseEndTick() const;
+    /**
+     * @return Tick when the zone radius reaches `lastRespawnZoneRadius`.
+     */
+    int lastRespawnTick() const;
+
+    /**
+     * @return Number of ticks from the current tick until @p point is within @p margin of the zone
+     * edge (0 if it already is).
+     */
+    int ticksUntilOutside(const model::Vec2 &point, double margin = 0) const;
+    /**
+     * @return Latest tick at which a unit at @p point can start moving at @p speed (per second)
+     * and still stay @p margin inside the zone until it reaches the next zone.
+     */
+    int latestDepartureTick(const model::Vec2 &point, double speed, double margin = 0) const;
+
+private:
+    const model::Constants &m_constants;
+    // zone radius change per tick
+    const double m_radiusSpeed;
+
+    model::Vec2 m_nextCenter;
+    double m_nextRadius = -1;
+
+    int m_phaseStartTick = 0;
+    int m_currentTick = 0;
+    double m_phaseTicks = 0;
+    model::Vec2 m_startCenter;
+    double m_startRadius = 0;
+    model::Vec2 m_centerVelocity;
+};